@@ -0,0 +1,22 @@
+#include "common.h"
+
+// Entry point for all benchmark executables. Each executable runs every suite that has been
+// linked into it: the per-source executables contain a single suite, sycl-bench contains all of them.
+int main(int argc, char** argv) {
+  BenchmarkApp app(argc, argv);
+  app.measureRooflinePeaks();
+
+  // --suite=<regex> selects suites by name, e.g. to give groups of suites different options
+  std::optional<std::regex> suite_filter;
+  if(app.getArgs().cli.isArgSet("--suite")) {
+    suite_filter = std::regex{app.getArgs().cli.get<std::string>("--suite")};
+  }
+
+  for(const auto& suite : BenchmarkRegistry::get().getSuites()) {
+    if(suite_filter.has_value() && !std::regex_search(suite.name, *suite_filter))
+      continue;
+    app.runSuite(suite);
+  }
+
+  return 0;
+}
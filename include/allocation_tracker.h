@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Counts the bytes currently allocated through the memory wrappers (PrefetchedBuffer and USMBuffer),
+ * per kind of memory, as well as the peak since the last call to resetPeaks().
+ */
+class AllocationTracker {
+public:
+  enum Kind { buffer = 0, usm_device, usm_host, usm_shared, num_kinds };
+
+  static AllocationTracker& get() {
+    static AllocationTracker tracker;
+    return tracker;
+  }
+
+  void allocate(Kind kind, std::size_t bytes) {
+    auto& c = counters[kind];
+    const std::size_t now = c.current.fetch_add(bytes) + bytes;
+    std::size_t peak = c.peak.load();
+    while(now > peak && !c.peak.compare_exchange_weak(peak, now)) {
+    }
+  }
+
+  void deallocate(Kind kind, std::size_t bytes) { counters[kind].current.fetch_sub(bytes); }
+
+  std::size_t getCurrent(Kind kind) const { return counters[kind].current.load(); }
+
+  std::size_t getPeak(Kind kind) const { return counters[kind].peak.load(); }
+
+  // Starts a new measurement interval, in which the peak starts at the currently allocated bytes
+  void resetPeaks() {
+    for(auto& c : counters) c.peak.store(c.current.load());
+  }
+
+  static const char* getName(Kind kind) {
+    switch(kind) {
+    case buffer: return "buffer";
+    case usm_device: return "usm-device";
+    case usm_host: return "usm-host";
+    case usm_shared: return "usm-shared";
+    default: return "unknown";
+    }
+  }
+
+private:
+  struct Counter {
+    std::atomic<std::size_t> current{0};
+    std::atomic<std::size_t> peak{0};
+  };
+
+  Counter counters[num_kinds];
+};
@@ -1,6 +1,8 @@
 #ifndef BENCHMARK_HOOK_HPP
 #define BENCHMARK_HOOK_HPP
 
+#include <cstddef>
+
 #include "result_consumer.h"
 
 class BenchmarkHook {
@@ -11,6 +13,8 @@ public:
   virtual void preKernel() = 0;
   virtual void postKernel() = 0;
   virtual void emitResults(ResultConsumer&) {}
+  // Number of back-to-back runs between preKernel() and postKernel() (--inner-iterations)
+  virtual void setInnerIterations(std::size_t) {}
 
   virtual ~BenchmarkHook() {}
 };
@@ -17,6 +17,17 @@ struct SupportsQueueProfiling<T,
   static constexpr bool value = true;
 };
 
+// Benchmarks declaring static constexpr bool idempotent = true leave their state unchanged across runs
+template <typename T, typename = void>
+struct IsIdempotent {
+  static constexpr bool value = false;
+};
+
+template <typename T>
+struct IsIdempotent<T, std::void_t<decltype(T::idempotent)>> {
+  static constexpr bool value = T::idempotent;
+};
+
 #define MAKE_HAS_METHOD_TRAIT(T, method, name)                                                                         \
   template <typename _T>                                                                                               \
   static constexpr std::false_type _has_##method(...);                                                                 \
@@ -28,8 +39,17 @@ template <typename T>
 struct BenchmarkTraits {
   MAKE_HAS_METHOD_TRAIT(T, verify, hasVerify)
   MAKE_HAS_METHOD_TRAIT(T, getThroughputMetric, hasGetThroughputMetric)
+  MAKE_HAS_METHOD_TRAIT(T, reset, hasReset)
+  MAKE_HAS_METHOD_TRAIT(T, getLocalMemoryUsage, hasGetLocalMemoryUsage)
+  MAKE_HAS_METHOD_TRAIT(T, getBytesMoved, hasGetBytesMoved)
+  MAKE_HAS_METHOD_TRAIT(T, getFlops, hasGetFlops)
+  MAKE_HAS_METHOD_TRAIT(T, getRooflineCeiling, hasGetRooflineCeiling)
+  MAKE_HAS_METHOD_TRAIT(T, runNative, hasRunNative)
+  MAKE_HAS_METHOD_TRAIT(T, memory_backend, hasMemoryBackend)
+  MAKE_HAS_METHOD_TRAIT(T, getTransferBytes, hasGetTransferBytes)
 
   static constexpr bool supportsQueueProfiling = SupportsQueueProfiling<T>::value;
+  static constexpr bool isIdempotent = IsIdempotent<T>::value;
 };
 
 } // namespace detail
@@ -5,11 +5,13 @@
 #include <sycl/sycl.hpp> // float4 definition
 #include <vector>
 
+#include "image_source.h"
+
 using std::string;
 
 
-void load_bitmap_mirrored(string filename, int size, sycl::float4* input);
-void save_bitmap(string filename, int size, const sycl::float4* output);
+inline void load_bitmap_mirrored(int size, sycl::float4* input);
+inline void save_bitmap(string filename, int size, const sycl::float4* output);
 
 /**
   A single Pixel in the image. A Pixel has red, green, and blue
@@ -136,7 +138,7 @@ struct bmpfile_dib_info {
  *
  * @param name of the filename to be opened and read as a matrix of pixels
  **/
-void Bitmap::open(std::string filename) {
+inline void Bitmap::open(std::string filename) {
   std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
   // clear data if already holds information
   for(int i = 0; i < pixels.size(); i++) {
@@ -222,7 +224,7 @@ void Bitmap::open(std::string filename) {
  *
  * @param name of the filename to be written as a bmp image
  **/
-void Bitmap::save(std::string filename) {
+inline void Bitmap::save(std::string filename) {
   std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
 
   if(file.fail()) {
@@ -288,7 +290,7 @@ void Bitmap::save(std::string filename) {
  *
  * @return boolean value of whether or not the matrix is a valid image
  **/
-bool Bitmap::isImage() {
+inline bool Bitmap::isImage() {
   const int height = pixels.size();
 
   if(height == 0 || pixels[0].size() == 0) {
@@ -317,7 +319,7 @@ bool Bitmap::isImage() {
  *
  * @return the bitmap image, represented by a matrix of RGB pixels
  **/
-PixelMatrix Bitmap::toPixelMatrix() {
+inline PixelMatrix Bitmap::toPixelMatrix() {
   if(isImage()) {
     return pixels;
   } else {
@@ -333,52 +335,59 @@ PixelMatrix Bitmap::toPixelMatrix() {
  *
  * @param a matrix of pixels to represent a bitmap
  **/
-void Bitmap::fromPixelMatrix(const PixelMatrix& values) { pixels = values; }
-
+inline void Bitmap::fromPixelMatrix(const PixelMatrix& values) { pixels = values; }
 
-#endif
 
+// Fills input with size x size pixels of the input image (see ImageSource), repeated in both dimensions
+inline void load_bitmap_mirrored(int size, sycl::float4* input) {
+  ImageSource::get().loadTiled(input, size, [](std::uint8_t r, std::uint8_t g, std::uint8_t b) {
+    return sycl::float4(r / 255.0f, g / 255.0f, b / 255.0f, 1.0f);
+  });
+}
 
-void load_bitmap_mirrored(string filename, int size, std::vector<sycl::float4>& input) {
-  Bitmap input_image;
-  input_image.open(filename);
-  // std::cout << "input image " << filename << " loaded" << std::endl;
-  PixelMatrix pixels = input_image.toPixelMatrix();
-  int w = pixels.size();
-  int h;
-  if(w > 0)
-    h = pixels[0].size();
-  else
-    h = 0;
-  // prepare the input buffer (similar to a GL_MIRRORED_REPEAT of the input picture)
-  input.resize(size * size);
-  for(size_t i = 0; i < size; i++)
-    for(size_t j = 0; j < size; j++) {
-      Pixel pixel = pixels[i % w][j % h];                                                            // mirror repeat
-      sycl::float4 color = sycl::float4(pixel.r / 255.0f, pixel.g / 255.0f, pixel.b / 255.0f, 1.0f); // cast to float
-      input[j + i * size] = color; // write to input buffer
-    }
-  // std::cout << "image resized to match the input size: ";
-  // std::cout << "[" << w << "x" << h << "] => [" << size << "x" << size << "]" << std::endl;
+inline void load_bitmap_mirrored(int size, std::vector<sycl::float4>& input) {
+  input.resize(static_cast<std::size_t>(size) * size);
+  load_bitmap_mirrored(size, input.data());
 }
 
-void save_bitmap(string filename, int size, sycl::float4* output) {
-  // write the output picture
-  // std::cout << "saving the output picture in " << filename << std::endl;
-  Bitmap output_image;
-  PixelMatrix pixels;
-  pixels.resize(size);
-  // std::cout << "debug " << size << " - " << output.size() << std::endl;
-  for(size_t i = 0; i < size; i++) {
-    pixels[i].resize(size);
-    for(size_t j = 0; j < size; j++) {
-      sycl::float4 color = output[i * size + j] * 255.f;
-      // std::cout << color.x() << "," << color.z() << "/";
-      pixels[i][j].r = (int)color.x();
-      pixels[i][j].g = (int)color.y();
-      pixels[i][j].b = (int)color.z();
+inline void save_bitmap(string filename, int size, const sycl::float4* output) {
+  // Writes the rows bottom-up in blocks instead of pixel by pixel, as large outputs take a long time otherwise
+  std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+  if(file.fail()) {
+    std::cout << filename << " could not be opened for editing. "
+              << "Is it already open by another program or is it read-only?\n";
+    return;
+  }
+  const std::size_t stride = (3 * static_cast<std::size_t>(size) + 3) & ~std::size_t{3};
+
+  bmpfile_magic magic;
+  magic.magic[0] = 'B';
+  magic.magic[1] = 'M';
+  file.write((char*)(&magic), sizeof(magic));
+  bmpfile_header header = {0};
+  header.bmp_offset = sizeof(bmpfile_magic) + sizeof(bmpfile_header) + sizeof(bmpfile_dib_info);
+  header.file_size = header.bmp_offset + stride * size;
+  file.write((char*)(&header), sizeof(header));
+  bmpfile_dib_info dib_info = {0};
+  dib_info.header_size = sizeof(bmpfile_dib_info);
+  dib_info.width = size;
+  dib_info.height = size;
+  dib_info.num_planes = 1;
+  dib_info.bits_per_pixel = 24;
+  dib_info.hres = 2835;
+  dib_info.vres = 2835;
+  file.write((char*)(&dib_info), sizeof(dib_info));
+
+  std::vector<uchar_t> row_data(stride, 0);
+  for(int row = size - 1; row >= 0; row--) {
+    for(std::size_t col = 0; col < static_cast<std::size_t>(size); col++) {
+      sycl::float4 color = output[row * static_cast<std::size_t>(size) + col] * 255.f;
+      row_data[3 * col] = (uchar_t)(int)color.z();
+      row_data[3 * col + 1] = (uchar_t)(int)color.y();
+      row_data[3 * col + 2] = (uchar_t)(int)color.x();
     }
+    file.write((char*)row_data.data(), stride);
   }
-  output_image.fromPixelMatrix(pixels);
-  output_image.save(filename);
 }
+
+#endif
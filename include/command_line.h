@@ -4,6 +4,7 @@
 #include "common.h"
 
 #include "result_consumer.h"
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -17,6 +18,22 @@
 using CommandLineArguments = std::unordered_map<std::string, std::string>;
 using FlagList = std::unordered_set<std::string>;
 
+/**
+ * Memory model used by benchmarks written against DeviceData (see memory_wrappers.h): SYCL buffers and
+ * accessors, or device, shared or host USM allocations.
+ */
+enum class MemoryBackend { buffer, usm_device, usm_shared, usm_host };
+
+inline std::string getMemoryBackendName(MemoryBackend backend) {
+  switch(backend) {
+  case MemoryBackend::buffer: return "buffer";
+  case MemoryBackend::usm_device: return "usm-device";
+  case MemoryBackend::usm_shared: return "usm-shared";
+  case MemoryBackend::usm_host: return "usm-host";
+  }
+  return "unknown";
+}
+
 namespace detail {
 
 template <class T>
@@ -53,6 +70,71 @@ inline SyclArraylike parseSyclArray(const std::string& s, std::size_t defaultVal
     throw std::invalid_argument{"Invalid sycl range/id: " + s};
 }
 
+/**
+ * Parses a parameter sweep specification into the list of values it describes. The specification
+ * is a comma-separated list of entries, each being either a single value or an inclusive range
+ * begin:end[:step]. The step is either additive (e.g. "+64" or "64") or multiplicative (e.g. "x2").
+ * The default step is +1. Example: "1024:4096:x2,10000" -> 1024, 2048, 4096, 10000
+ */
+inline std::vector<std::size_t> parseSweep(const std::string& s) {
+  std::vector<std::size_t> result;
+  std::stringstream istr(s);
+  std::string entry;
+
+  while(std::getline(istr, entry, ',')) {
+    const auto first_colon = entry.find(':');
+    if(first_colon == std::string::npos) {
+      result.push_back(simple_cast<std::size_t>(entry));
+      continue;
+    }
+
+    const auto second_colon = entry.find(':', first_colon + 1);
+    const auto begin = simple_cast<std::size_t>(entry.substr(0, first_colon));
+    const auto end = simple_cast<std::size_t>(entry.substr(first_colon + 1, second_colon - first_colon - 1));
+    std::string step = second_colon == std::string::npos ? "+1" : entry.substr(second_colon + 1);
+
+    const bool multiplicative = !step.empty() && step[0] == 'x';
+    if(!step.empty() && (step[0] == 'x' || step[0] == '+'))
+      step = step.substr(1);
+    const auto step_size = simple_cast<std::size_t>(step);
+
+    if(begin == 0 || step_size == 0 || (multiplicative && step_size == 1))
+      throw std::invalid_argument{"Invalid parameter sweep: " + entry};
+
+    for(std::size_t v = begin; v <= end; v = multiplicative ? v * step_size : v + step_size) {
+      result.push_back(v);
+      // Stop before the next value would wrap around, e.g. for end = SIZE_MAX
+      if(multiplicative ? v > end / step_size : step_size > end - v)
+        break;
+    }
+  }
+
+  if(result.empty())
+    throw std::invalid_argument{"Empty parameter sweep: " + s};
+
+  return result;
+}
+
+// Parses a comma-separated list of memory backends, e.g. "buffer,usm-device"; "all" selects all of them
+inline std::vector<MemoryBackend> parseMemoryBackends(const std::string& s) {
+  const std::vector<MemoryBackend> all = {
+      MemoryBackend::buffer, MemoryBackend::usm_device, MemoryBackend::usm_shared, MemoryBackend::usm_host};
+  if(s == "all")
+    return all;
+
+  std::vector<MemoryBackend> result;
+  for(const auto& entry : parseCommaDelimitedList<std::string>(s)) {
+    const auto it = std::find_if(
+        all.begin(), all.end(), [&](MemoryBackend backend) { return getMemoryBackendName(backend) == entry; });
+    if(it == all.end())
+      throw std::invalid_argument{"Invalid memory backend: " + entry};
+    result.push_back(*it);
+  }
+  if(result.empty())
+    throw std::invalid_argument{"Empty list of memory backends: " + s};
+  return result;
+}
+
 } // namespace detail
 
 template <class T>
@@ -126,6 +208,31 @@ struct VerificationSetting {
   sycl::range<3> range = {1, 1, 1};
 };
 
+/**
+ * Controls statistical stopping of the measurement loop. When enabled, runs are repeated until
+ * the relative half-width of the 95% confidence interval of the median run-time drops below
+ * target_rel_ci, subject to the min/max run counts and the wall-clock budget (in seconds).
+ * The budget is only checked once min_runs have been completed.
+ */
+struct AdaptiveRunSetting {
+  bool enabled = false;
+  double target_rel_ci = 0.02;
+  std::size_t min_runs = 5;
+  std::size_t max_runs = 1000;
+  double time_budget = 600.0;
+};
+
+/**
+ * The problem and local sizes given by --size and --local and the memory backends given by --memory.
+ * Each may describe a sweep over several values (see detail::parseSweep), in which case every
+ * combination is run within the same process.
+ */
+struct ParameterSweep {
+  std::vector<std::size_t> problem_sizes;
+  std::vector<std::size_t> local_sizes;
+  std::vector<MemoryBackend> memory_backends;
+};
+
 struct BenchmarkArgs {
   size_t problem_size;
   size_t local_size;
@@ -133,10 +240,13 @@ struct BenchmarkArgs {
   sycl::queue device_queue;
   sycl::queue device_queue_in_order;
   VerificationSetting verification;
+  AdaptiveRunSetting adaptive_runs;
+  ParameterSweep sweep;
   // can be used to query additional benchmark specific information from the command line
   CommandLine cli;
   std::shared_ptr<ResultConsumer> result_consumer;
   bool warmup_run;
+  MemoryBackend memory_backend = MemoryBackend::buffer;
 };
 
 
@@ -145,8 +255,12 @@ public:
   BenchmarkCommandLine(int argc, char** argv) : cli_parser{argc, argv} {}
 
   BenchmarkArgs getBenchmarkArgs() const {
-    std::size_t size = cli_parser.getOrDefault<std::size_t>("--size", 3072);
-    std::size_t local_size = cli_parser.getOrDefault<std::size_t>("--local", 256);
+    ParameterSweep sweep;
+    sweep.problem_sizes = detail::parseSweep(cli_parser.getOrDefault<std::string>("--size", "3072"));
+    sweep.local_sizes = detail::parseSweep(cli_parser.getOrDefault<std::string>("--local", "256"));
+    sweep.memory_backends = detail::parseMemoryBackends(cli_parser.getOrDefault<std::string>("--memory", "buffer"));
+    std::size_t size = sweep.problem_sizes.front();
+    std::size_t local_size = sweep.local_sizes.front();
     std::size_t num_runs = cli_parser.getOrDefault<std::size_t>("--num-runs", 5);
 
     std::string device_type = cli_parser.getOrDefault<std::string>("--device", "default");
@@ -161,18 +275,37 @@ public:
 
     auto verification_range = cli_parser.getOrDefault<sycl::range<3>>("--verification-range", sycl::range<3>{1, 1, 1});
 
+    AdaptiveRunSetting adaptive_runs;
+    if(cli_parser.isArgSet("--target-ci")) {
+      adaptive_runs.enabled = true;
+      adaptive_runs.target_rel_ci = cli_parser.get<double>("--target-ci");
+      adaptive_runs.min_runs = cli_parser.getOrDefault<std::size_t>("--min-runs", adaptive_runs.min_runs);
+      adaptive_runs.max_runs = cli_parser.getOrDefault<std::size_t>("--max-runs", adaptive_runs.max_runs);
+      adaptive_runs.time_budget = cli_parser.getOrDefault<double>("--time-budget", adaptive_runs.time_budget);
+      if(adaptive_runs.min_runs > adaptive_runs.max_runs)
+        throw std::invalid_argument{"--min-runs must not be larger than --max-runs"};
+    }
+
     auto result_consumer = getResultConsumer(cli_parser.getOrDefault<std::string>("--output", "stdio"));
 
-    return BenchmarkArgs{size, local_size, num_runs, q, q_in_order,
-        VerificationSetting{verification_enabled, verification_begin, verification_range}, cli_parser, result_consumer};
+    BenchmarkArgs args{size, local_size, num_runs, q, q_in_order,
+        VerificationSetting{verification_enabled, verification_begin, verification_range}, adaptive_runs, sweep, cli_parser,
+        result_consumer};
+    args.memory_backend = sweep.memory_backends.front();
+    return args;
   }
 
 private:
   std::shared_ptr<ResultConsumer>
 
   getResultConsumer(const std::string& result_consumer_name) const {
+    const std::string jsonl_extension = ".jsonl";
     if(result_consumer_name == "stdio")
       return std::shared_ptr<ResultConsumer>{new OstreamResultConsumer{std::cout}};
+    else if(result_consumer_name.size() > jsonl_extension.size() &&
+            result_consumer_name.compare(result_consumer_name.size() - jsonl_extension.size(), jsonl_extension.size(),
+                jsonl_extension) == 0)
+      return std::shared_ptr<ResultConsumer>{new JsonLinesResultConsumer{result_consumer_name}};
     else
       // create result consumer that appends to a csv file, interpreting the output name
       // as the target file name
@@ -3,28 +3,50 @@
 
 #include <algorithm> // for std::min
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <regex>
+#include <set>
 #include <sstream>
 #include <string>
+#include <tuple>
 #include <type_traits>
-#include <unordered_set>
 
 #include "command_line.h"
+#include "registry.h"
 #include "result_consumer.h"
 #include "type_traits.h"
 
 
 #include "benchmark_hook.h"
 #include "benchmark_traits.h"
+#include "device_init.h"
+#include "host_placement.h"
+#include "image_source.h"
+#include "input_generator.h"
+#include "local_size_tuner.h"
 #include "memory_wrappers.h"
+#include "native_parallel.h"
+#include "reference_cache.h"
+#include "roofline.h"
+#include "streaming.h"
 #include "time_metrics.h"
+#include "transfer_model.h"
+#include "usm_pool.h"
 
 #ifdef NV_ENERGY_MEAS
 #include "nv_energy_meas.h"
 #endif
 
+#ifdef __linux__
+#include "memory_footprint_hook.h"
+#include "perf_event_hook.h"
+#include "rapl_energy_hook.h"
+#endif
+
 
 template <class Benchmark>
 class BenchmarkManager {
@@ -35,49 +57,105 @@ public:
 
   template <typename... Args>
   void run(Args&&... additionalArgs) {
-    args.result_consumer->proceedToBenchmark(Benchmark{args, additionalArgs...}.getBenchmarkName(args));
+    const auto name = Benchmark{args, additionalArgs...}.getBenchmarkName(args);
+
+    // With --autotune-local, search the best local size first and use it for the actual measurement
+    std::optional<LocalSizeTuningResult> tuning;
+    if constexpr(detail::BenchmarkTraits<Benchmark>::hasGetLocalMemoryUsage) {
+      if(args.cli.isFlagSet("--autotune-local")) {
+        tuning = LocalSizeTuner<Benchmark>{args}.tune(name, additionalArgs...);
+        args.local_size = tuning->best_local_size;
+      }
+    }
+
+    args.result_consumer->proceedToBenchmark(name);
 
     args.result_consumer->consumeResult("problem-size", std::to_string(args.problem_size));
     args.result_consumer->consumeResult("local-size", std::to_string(args.local_size));
+    args.result_consumer->consumeResult("memory-backend", getMemoryBackendName(args.memory_backend));
     args.result_consumer->consumeResult(
         "device-name", args.device_queue.get_device().get_info<sycl::info::device::name>());
     args.result_consumer->consumeResult("sycl-implementation", this->getSyclImplementation());
+    HostPlacement::get().emitResults(*args.result_consumer);
 
     TimeMetricsProcessor<Benchmark> time_metrics(args);
 
+    USMPool::resetTotalStatistics();
+    StreamingPipeline::resetStatistics();
     for(auto h : hooks) h->atInit();
 
+    const auto benchmark_start = std::chrono::steady_clock::now();
+    // With adaptive run counts, keep running until the median run-time is known precisely enough,
+    // the run limit is hit or the time budget is exhausted. Otherwise, do exactly num_runs runs.
+    const auto needsMoreRuns = [&](std::size_t completed_runs) {
+      const auto& adaptive = args.adaptive_runs;
+      if(!adaptive.enabled)
+        return completed_runs < args.num_runs;
+      if(completed_runs < adaptive.min_runs)
+        return true;
+      if(completed_runs >= adaptive.max_runs)
+        return false;
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - benchmark_start;
+      if(elapsed.count() >= adaptive.time_budget)
+        return false;
+      return time_metrics.getRelativeMedianCI("run-time") > adaptive.target_rel_ci;
+    };
+
+    // In setup-once mode, the benchmark is only constructed and set up for the first run.
+    // Subsequent runs reuse it, calling reset() in between if the benchmark provides it.
+    const bool setup_once = args.cli.isFlagSet("--setup-once");
+    std::optional<std::chrono::nanoseconds> setup_time;
+
+    std::size_t inner_iterations = 1;
+    std::optional<double> native_time;
+
     bool all_runs_pass = true;
     try {
-      // Run until we have as many runs as requested or until
-      // verification fails
-      for(std::size_t run = 0; run < args.num_runs && all_runs_pass; ++run) {
-        Benchmark b(args, additionalArgs...);
-
-        for(auto h : hooks) h->preSetup();
+      inner_iterations = getInnerIterations(additionalArgs...);
+      for(auto h : hooks) h->setInnerIterations(inner_iterations);
 
-        b.setup();
+      std::optional<Benchmark> benchmark;
 
-        args.device_queue.wait_and_throw();
-        for(auto h : hooks) h->postSetup();
+      // Run until we have as many runs as requested or until
+      // verification fails
+      for(std::size_t run = 0; needsMoreRuns(run) && all_runs_pass; ++run) {
+        if(!setup_once || !benchmark) {
+          // Destroy the previous instance first so that its resources are released
+          benchmark.reset();
+          benchmark.emplace(args, additionalArgs...);
+
+          for(auto h : hooks) h->preSetup();
+          const auto setup_begin = std::chrono::high_resolution_clock::now();
+
+          benchmark->setup();
+
+          args.device_queue.wait_and_throw();
+          const auto setup_end = std::chrono::high_resolution_clock::now();
+          for(auto h : hooks) h->postSetup();
+
+          if(setup_once)
+            setup_time = std::chrono::duration_cast<std::chrono::nanoseconds>(setup_end - setup_begin);
+        } else if constexpr(detail::BenchmarkTraits<Benchmark>::hasReset) {
+          benchmark->reset();
+          args.device_queue.wait_and_throw();
+        }
+        Benchmark& b = *benchmark;
 
         std::vector<sycl::event> run_events;
-        run_events.reserve(1024); // Make sure we don't need to resize during benchmarking.
+        // Make sure we don't need to resize during benchmarking.
+        run_events.reserve(std::max<std::size_t>(1024, 4 * inner_iterations));
 
         // Performance critical measurement section starts here
         for(auto h : hooks) h->preKernel();
         const auto before = std::chrono::high_resolution_clock::now();
-        if constexpr(detail::BenchmarkTraits<Benchmark>::supportsQueueProfiling) {
-          b.run(run_events);
-        } else {
-          b.run();
-        }
+        runBatch(b, inner_iterations, run_events);
         args.device_queue.wait_and_throw();
         const auto after = std::chrono::high_resolution_clock::now();
         for(auto h : hooks) h->postKernel();
         // Performance critical measurement section ends here
 
-        auto run_time = std::chrono::duration_cast<std::chrono::nanoseconds>(after - before);
+        // All timings are reported per single run() invocation
+        auto run_time = std::chrono::duration_cast<std::chrono::nanoseconds>(after - before) / inner_iterations;
         time_metrics.addTimingResult("run-time", run_time);
 
         if(detail::BenchmarkTraits<Benchmark>::supportsQueueProfiling) {
@@ -94,6 +172,8 @@ public:
             total_time += std::chrono::nanoseconds(end - start);
             submit_time += std::chrono::nanoseconds(start - submit);
           }
+          total_time /= inner_iterations;
+          submit_time /= inner_iterations;
           system_time += std::chrono::nanoseconds(run_time - total_time);
 
           time_metrics.addTimingResult("kernel-time", total_time);
@@ -111,7 +191,10 @@ public:
         }
 
         if constexpr(detail::BenchmarkTraits<Benchmark>::hasVerify) {
-          if(args.verification.range.size() > 0) {
+          // Without reset(), a reused benchmark may carry over state from previous runs
+          // (e.g. accumulating outputs), so only the first run can be verified.
+          const bool has_fresh_state = !setup_once || run == 0 || detail::BenchmarkTraits<Benchmark>::hasReset;
+          if(args.verification.range.size() > 0 && has_fresh_state) {
             if(args.verification.enabled) {
               if(!b.verify(args.verification)) {
                 all_runs_pass = false;
@@ -120,6 +203,14 @@ public:
           }
         }
       }
+
+      if constexpr(detail::BenchmarkTraits<Benchmark>::hasRunNative) {
+        if(args.cli.isFlagSet("--native")) {
+          // Release the resources of the SYCL benchmark instance first
+          benchmark.reset();
+          native_time = measureNativeTime(additionalArgs...);
+        }
+      }
     } catch(...) {
       args.result_consumer->discard();
       std::rethrow_exception(std::current_exception());
@@ -127,6 +218,29 @@ public:
 
     time_metrics.emitResults(*args.result_consumer);
 
+    if(setup_time.has_value()) {
+      args.result_consumer->consumeResult("setup-time", std::to_string(setup_time->count() / 1.0e9), "s");
+    } else {
+      args.result_consumer->consumeResult("setup-time", "N/A");
+    }
+    args.result_consumer->consumeResult("inner-iterations", std::to_string(inner_iterations));
+    emitTuningResults(tuning);
+    if(args.cli.isFlagSet("--native")) {
+      emitNativeResults(native_time, time_metrics.getMedian("run-time"));
+    }
+    if(args.cli.isFlagSet("--roofline") || args.cli.isArgSet("--roofline-peaks")) {
+      emitRooflineResults(time_metrics.getMedian("run-time"));
+    }
+    if(USMPool::isEnabled()) {
+      emitUSMPoolResults();
+    }
+    if(StreamingPipeline::isEnabled()) {
+      emitStreamingResults(time_metrics.getMedian("run-time"));
+    }
+    if constexpr(detail::BenchmarkTraits<Benchmark>::hasGetTransferBytes) {
+      emitTransferModelResults(name, time_metrics.getMedian("run-time"));
+    }
+
     for(auto h : hooks) {
       // Extract results from the hooks
       h->emitResults(*args.result_consumer);
@@ -150,6 +264,217 @@ private:
   BenchmarkArgs args;
   std::vector<BenchmarkHook*> hooks;
 
+  // Upper bound for automatically calibrated inner iterations
+  static constexpr std::size_t max_inner_iterations = 1000000;
+
+  void runBatch(Benchmark& b, std::size_t iterations, std::vector<sycl::event>& events) {
+    for(std::size_t i = 0; i < iterations; ++i) {
+      if constexpr(detail::BenchmarkTraits<Benchmark>::supportsQueueProfiling) {
+        b.run(events);
+      } else {
+        b.run();
+      }
+    }
+  }
+
+  /**
+   * Determines how many back-to-back run() invocations are measured in a single sample, as requested by
+   * --inner-iterations=<K|auto>. For "auto", the count is calibrated on a separate benchmark instance
+   * such that a sample lasts at least --min-sample-time seconds.
+   *
+   * Repeating run() without setup() in between is only valid for benchmarks that leave their state
+   * unchanged across runs, e.g. because they overwrite their outputs from unmodified inputs. Benchmarks
+   * declare this with
+   *
+   *   static constexpr bool idempotent = true;
+   *
+   * All others, including those accumulating into their outputs, always use a single inner iteration.
+   */
+  template <typename... Args>
+  std::size_t getInnerIterations(Args&&... additionalArgs) {
+    if(!args.cli.isArgSet("--inner-iterations"))
+      return 1;
+
+    const auto requested = args.cli.get<std::string>("--inner-iterations");
+    if constexpr(!detail::BenchmarkTraits<Benchmark>::isIdempotent) {
+      std::cerr << "Benchmark is not idempotent, ignoring --inner-iterations=" << requested << std::endl;
+      return 1;
+    }
+
+    if(requested != "auto") {
+      const auto iterations = cast<std::size_t>(requested);
+      if(iterations == 0)
+        throw std::invalid_argument{"--inner-iterations must be at least 1"};
+      return iterations;
+    }
+
+    const double min_sample_time = args.cli.getOrDefault<double>("--min-sample-time", 0.01);
+
+    Benchmark b(args, additionalArgs...);
+    b.setup();
+    args.device_queue.wait_and_throw();
+
+    std::vector<sycl::event> events;
+    std::size_t iterations = 1;
+    while(iterations < max_inner_iterations) {
+      events.clear();
+      const auto before = std::chrono::high_resolution_clock::now();
+      runBatch(b, iterations, events);
+      args.device_queue.wait_and_throw();
+      const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - before;
+      if(elapsed.count() >= min_sample_time)
+        break;
+      // Extrapolate from the current measurement with some headroom, but grow by at most 10x per step
+      const double multiplier =
+          elapsed.count() > 0.0 ? std::min(1.4 * min_sample_time / elapsed.count(), 10.0) : 10.0;
+      const auto next = static_cast<std::size_t>(std::ceil(iterations * multiplier));
+      iterations = std::min(std::max(next, iterations + 1), max_inner_iterations);
+    }
+    return iterations;
+  }
+
+  /**
+   * Returns the median time in seconds of the native CPU implementation of the benchmark, runNative(),
+   * which is measured on a separately set up instance after one warmup run. The number of runs is the
+   * same as for the SYCL implementation, or the minimum number of runs with --target-ci.
+   */
+  template <typename... Args>
+  double measureNativeTime(Args&&... additionalArgs) {
+    Benchmark b(args, additionalArgs...);
+    b.setup();
+    args.device_queue.wait_and_throw();
+
+    b.runNative();
+
+    const std::size_t num_runs = args.adaptive_runs.enabled ? args.adaptive_runs.min_runs : args.num_runs;
+    std::vector<double> times;
+    for(std::size_t run = 0; run < std::max<std::size_t>(num_runs, 1); ++run) {
+      const auto before = std::chrono::high_resolution_clock::now();
+      b.runNative();
+      const auto after = std::chrono::high_resolution_clock::now();
+      times.push_back(std::chrono::duration<double>(after - before).count());
+      args.result_consumer->consumeSample("native-time", run, times.back(), "s");
+    }
+    std::sort(times.begin(), times.end());
+    return detail::median(times);
+  }
+
+  void emitNativeResults(std::optional<double> native_time, std::optional<double> median_run_time) const {
+    if(!native_time.has_value()) {
+      args.result_consumer->consumeResult("native-time", "N/A");
+      args.result_consumer->consumeResult("native-overhead", "N/A");
+      return;
+    }
+    args.result_consumer->consumeResult("native-time", std::to_string(*native_time), "s");
+    if(median_run_time.has_value() && *native_time > 0.0) {
+      args.result_consumer->consumeResult("native-overhead", std::to_string(*median_run_time / *native_time));
+    } else {
+      args.result_consumer->consumeResult("native-overhead", "N/A");
+    }
+  }
+
+  // Allocations served by the USM pools during this benchmark, including setup() and verification
+  void emitUSMPoolResults() const {
+    const auto stats = USMPool::getTotalStatistics();
+    args.result_consumer->consumeResult("usm-pool-allocations", std::to_string(stats.allocations));
+    if(stats.allocations > 0) {
+      args.result_consumer->consumeResult(
+          "usm-pool-hit-rate", std::to_string(100.0 * stats.hits / stats.allocations), "%");
+    } else {
+      args.result_consumer->consumeResult("usm-pool-hit-rate", "N/A");
+    }
+    args.result_consumer->consumeResult("usm-pool-peak-cached-bytes", std::to_string(stats.peak_cached_bytes), "B");
+  }
+
+  /**
+   * Stage times of the serial calibration pass of streaming benchmarks (see StreamingPipeline) and the
+   * overlap ratio of the pipelined runs: the time saved compared to the serial pass, relative to the time
+   * a perfect pipeline limited only by its slowest stage would save. Due to measurement noise, the ratio can
+   * fall slightly outside of [0, 1], so it is clamped to that range.
+   */
+  void emitStreamingResults(std::optional<double> median_run_time) const {
+    auto& consumer = *args.result_consumer;
+    const auto& stats = StreamingPipeline::getStatistics();
+    if(!stats.has_value()) {
+      for(const auto* name : {"streaming-tiles", "streaming-tile-size", "streaming-depth", "streaming-h2d-time",
+              "streaming-compute-time", "streaming-d2h-time", "streaming-overlap-ratio"}) {
+        consumer.consumeResult(name, "N/A");
+      }
+      return;
+    }
+    consumer.consumeResult("streaming-tiles", std::to_string(stats->num_tiles));
+    consumer.consumeResult("streaming-tile-size", std::to_string(stats->tile_bytes), "B");
+    consumer.consumeResult("streaming-depth", std::to_string(stats->depth));
+    consumer.consumeResult("streaming-h2d-time", std::to_string(stats->serial_h2d_time), "s");
+    consumer.consumeResult("streaming-compute-time", std::to_string(stats->serial_compute_time), "s");
+    consumer.consumeResult("streaming-d2h-time", std::to_string(stats->serial_d2h_time), "s");
+
+    const double slowest_stage =
+        std::max({stats->serial_h2d_time, stats->serial_compute_time, stats->serial_d2h_time});
+    const double hideable_time = stats->getSerialTime() - slowest_stage;
+    if(median_run_time.has_value() && hideable_time > 0.0) {
+      const double ratio = std::clamp((stats->getSerialTime() - *median_run_time) / hideable_time, 0.0, 1.0);
+      consumer.consumeResult("streaming-overlap-ratio", std::to_string(ratio));
+    } else {
+      consumer.consumeResult("streaming-overlap-ratio", "N/A");
+    }
+  }
+
+  void emitTuningResults(const std::optional<LocalSizeTuningResult>& tuning) const {
+    if(!tuning.has_value()) {
+      args.result_consumer->consumeResult("autotune-curve", "N/A");
+      return;
+    }
+    if(tuning->from_cache) {
+      args.result_consumer->consumeResult("autotune-curve", "cached");
+      return;
+    }
+    // Emitted as "<local-size>:<median run-time> ..." in the same format as the samples
+    std::stringstream curve;
+    curve << "\"";
+    for(std::size_t i = 0; i < tuning->response_curve.size(); ++i) {
+      curve << tuning->response_curve[i].first << ":" << std::to_string(tuning->response_curve[i].second);
+      if(i != tuning->response_curve.size() - 1) {
+        curve << " ";
+      }
+    }
+    curve << "\"";
+    args.result_consumer->consumeResult("autotune-curve", curve.str());
+  }
+
+  void emitRooflineResults(std::optional<double> median_run_time) const {
+    std::optional<double> bytes, flops;
+    if constexpr(detail::BenchmarkTraits<Benchmark>::hasGetBytesMoved) {
+      bytes = Benchmark::getBytesMoved(args);
+    }
+    if constexpr(detail::BenchmarkTraits<Benchmark>::hasGetFlops) {
+      flops = Benchmark::getFlops(args);
+    }
+
+    auto& roofline = RooflineModel::get();
+    const auto device = args.device_queue.get_device().get_info<sycl::info::device::name>();
+    if constexpr(detail::BenchmarkTraits<Benchmark>::hasGetRooflineCeiling) {
+      if(median_run_time.has_value() && *median_run_time > 0.0) {
+        const auto ceiling = Benchmark::getRooflineCeiling();
+        if(ceiling == RooflineCeiling::memory_bandwidth && bytes.has_value()) {
+          roofline.recordPeak(device, ceiling, *bytes / *median_run_time);
+        } else if(ceiling == RooflineCeiling::compute && flops.has_value()) {
+          roofline.recordPeak(device, ceiling, *flops / *median_run_time);
+        }
+      }
+    }
+    roofline.emitResults(*args.result_consumer, device, bytes, flops, median_run_time);
+  }
+
+  // Adds the median time to the curve of the transfer path and emits the refitted latency-bandwidth model
+  void emitTransferModelResults(const std::string& name, std::optional<double> median_run_time) const {
+    auto& model = TransferModel::get();
+    const auto device = args.device_queue.get_device().get_info<sycl::info::device::name>();
+    if(median_run_time.has_value())
+      model.recordPoint(device, name, Benchmark::getTransferBytes(args), *median_run_time);
+    model.emitResults(*args.result_consumer, device, name);
+  }
+
   std::string getSyclImplementation() const {
 #if defined(__ACPP__)
     return "AdaptiveCpp";
@@ -167,12 +492,62 @@ private:
 class BenchmarkApp {
   BenchmarkArgs args;
   sycl::queue device_queue;
-  std::unordered_set<std::string> benchmark_names;
+  // Benchmarks that have already been run, identified by name, problem size, local size and memory backend
+  std::set<std::tuple<std::string, std::size_t, std::size_t, MemoryBackend>> benchmark_runs;
+  // Only benchmarks whose name matches the --filter regex are run
+  std::optional<std::regex> filter;
+  // With --list, benchmarks are only printed instead of being run
+  bool list_only = false;
+  const BenchmarkSuite* current_suite = nullptr;
+  // Names printed by --list, which prints every benchmark once even if it runs at several sweep points
+  std::set<std::string> listed_benchmarks;
+  // While measuring the roofline peaks, only benchmarks declaring a roofline ceiling are run
+  bool measuring_roofline_peaks = false;
 
 public:
   BenchmarkApp(int argc, char** argv) {
     try {
+      // Must be done before the queues are created, so that runtime threads inherit the CPU affinity
+      HostPlacement::get().apply(CommandLine{argc, argv});
       args = BenchmarkCommandLine{argc, argv}.getBenchmarkArgs();
+      if(args.cli.isArgSet("--filter")) {
+        filter = std::regex{args.cli.get<std::string>("--filter")};
+      }
+      list_only = args.cli.isFlagSet("--list");
+      if(args.cli.isArgSet("--native-threads")) {
+        NativeThreadPool::setNumThreads(args.cli.get<std::size_t>("--native-threads"));
+      }
+      if(args.cli.isFlagSet("--usm-pool") || args.cli.isArgSet("--usm-pool-limit")) {
+        USMPool::setEnabled(true);
+      }
+      if(args.cli.isArgSet("--usm-pool-limit")) {
+        USMPool::setMaxCachedBytes(args.cli.get<std::size_t>("--usm-pool-limit"));
+      }
+      if(args.cli.isFlagSet("--streaming") || args.cli.isArgSet("--stream-tile") ||
+          args.cli.isArgSet("--stream-depth")) {
+        StreamingPipeline::setEnabled(true);
+      }
+      if(args.cli.isArgSet("--stream-tile")) {
+        StreamingPipeline::setTileBytes(args.cli.get<std::size_t>("--stream-tile"));
+      }
+      if(args.cli.isArgSet("--stream-depth")) {
+        StreamingPipeline::setDepth(args.cli.get<std::size_t>("--stream-depth"));
+      }
+      if(args.cli.isFlagSet("--no-host-mirror")) {
+        DeviceInit::setEnabled(true);
+      }
+      if(args.cli.isArgSet("--verification-samples")) {
+        DeviceInit::setNumSamples(args.cli.get<std::size_t>("--verification-samples"));
+      }
+      if(args.cli.isArgSet("--image")) {
+        ImageSource::get().setPath(args.cli.get<std::string>("--image"));
+      }
+      if(args.cli.isArgSet("--reference-cache")) {
+        ReferenceCache::get().setDirectory(args.cli.get<std::string>("--reference-cache"));
+      }
+      if(args.cli.isArgSet("--roofline-peaks")) {
+        RooflineModel::get().setPeaksFile(args.cli.get<std::string>("--roofline-peaks"));
+      }
     } catch(std::exception& e) {
       std::cerr << "Error while parsing command lines: " << e.what() << std::endl;
     }
@@ -182,33 +557,181 @@ public:
 
   bool shouldRunNDRangeKernels() const { return !args.cli.isFlagSet("--no-ndrange-kernels"); }
 
+  // With --streaming, benchmarks supporting it run their out-of-core variants instead (see StreamingPipeline).
+  // The roofline peaks are always measured in-core.
+  bool shouldRunStreaming() const { return StreamingPipeline::isEnabled() && !measuring_roofline_peaks; }
+
   bool deviceHasAspect(sycl::aspect asp) const { return device_queue.get_device().has(asp); }
 
   bool deviceSupportsFP64() const { return deviceHasAspect(sycl::aspect::fp64); }
 
+  bool deviceSupportsAtomicMemoryOrder(sycl::memory_order order) const {
+    const auto orders = device_queue.get_device().get_info<sycl::info::device::atomic_memory_order_capabilities>();
+    return std::find(orders.begin(), orders.end(), order) != orders.end();
+  }
+
+  // Runs all benchmarks of a registered suite, once for every combination of problem size, local size
+  // and memory backend. All sweep points share the same queues, so kernels only need to be compiled once.
+  void runSuite(const BenchmarkSuite& suite) {
+    current_suite = &suite;
+    for(std::size_t problem_size : args.sweep.problem_sizes) {
+      for(std::size_t local_size : args.sweep.local_sizes) {
+        for(MemoryBackend memory_backend : args.sweep.memory_backends) {
+          args.problem_size = problem_size;
+          args.local_size = local_size;
+          args.memory_backend = memory_backend;
+          suite.run(*this);
+        }
+      }
+    }
+    current_suite = nullptr;
+  }
+
+  /**
+   * Calls f(backend) for every memory backend, where backend is a std::integral_constant that can be
+   * used as template argument of benchmarks written against DeviceData, e.g.
+   *
+   *   app.forEachMemoryBackend([&](auto backend) { app.run<VecAddBench<float, backend>>(); });
+   *
+   * run() only measures the instantiation matching the memory backend of the current sweep point.
+   */
+  template <typename F>
+  void forEachMemoryBackend(F&& f) {
+    f(std::integral_constant<MemoryBackend, MemoryBackend::buffer>{});
+    f(std::integral_constant<MemoryBackend, MemoryBackend::usm_device>{});
+    f(std::integral_constant<MemoryBackend, MemoryBackend::usm_shared>{});
+    f(std::integral_constant<MemoryBackend, MemoryBackend::usm_host>{});
+  }
+
+  /**
+   * With --roofline, measures the peaks of the device before any other benchmark is run, using the
+   * roofline ceiling benchmarks of the suites micro/DRAM and micro/arith at fixed problem sizes.
+   * Nothing is done if the peaks are already known from --roofline-peaks or if the suites are not
+   * part of this executable. The results of these runs are not reported.
+   */
+  void measureRooflinePeaks() {
+    if((!args.cli.isFlagSet("--roofline") && !args.cli.isArgSet("--roofline-peaks")) || list_only) {
+      return;
+    }
+    const auto device = args.device_queue.get_device().get_info<sycl::info::device::name>();
+    if(RooflineModel::get().hasPeaks(device)) {
+      return;
+    }
+
+    const auto saved_args = args;
+    args.result_consumer = std::make_shared<NullResultConsumer>();
+    args.local_size = 256;
+    args.memory_backend = MemoryBackend::buffer;
+    measuring_roofline_peaks = true;
+    // DRAM interprets the problem size as the edge length of a cube of bytes, i.e. 512 -> 128 MiB
+    for(const auto& [suite_name, problem_size] : {std::make_pair("DRAM", 512), std::make_pair("arith", 1 << 20)}) {
+      for(const auto& suite : BenchmarkRegistry::get().getSuites()) {
+        if(suite.name == suite_name) {
+          args.problem_size = problem_size;
+          suite.run(*this);
+        }
+      }
+    }
+    measuring_roofline_peaks = false;
+    args = saved_args;
+
+    if(!RooflineModel::get().hasPeaks(device)) {
+      std::cerr << "Roofline peaks of device '" << device << "' are unknown, run micro/DRAM and micro/arith "
+                << "with --roofline-peaks=<file> first or use the sycl-bench executable" << std::endl;
+    }
+  }
+
   template <class Benchmark, typename... AdditionalArgs>
   void run(AdditionalArgs&&... additional_args) {
     try {
-      const auto name = Benchmark{args, additional_args...}.getBenchmarkName(args);
-      if(benchmark_names.count(name) == 0) {
-        benchmark_names.insert(name);
-      } else {
-        std::cerr << "Benchmark with name '" << name << "' has already been run\n";
+      if(measuring_roofline_peaks) {
+        if constexpr(!detail::BenchmarkTraits<Benchmark>::hasGetRooflineCeiling) {
+          return;
+        } else if(Benchmark::getRooflineCeiling() == RooflineCeiling::none) {
+          return;
+        }
+      }
+
+      // Benchmarks not written against DeviceData only support buffers
+      if constexpr(detail::BenchmarkTraits<Benchmark>::hasMemoryBackend) {
+        if(Benchmark::memory_backend != args.memory_backend) {
+          return;
+        }
+      } else if(args.memory_backend != MemoryBackend::buffer) {
+        return;
+      }
+
+      // USM variants use the in-order queue instead of accessors to order their kernels
+      BenchmarkArgs benchmark_args = args;
+      if(args.memory_backend != MemoryBackend::buffer) {
+        benchmark_args.device_queue = args.device_queue_in_order;
+      }
+
+      const auto name = Benchmark{benchmark_args, additional_args...}.getBenchmarkName(benchmark_args);
+      if(!measuring_roofline_peaks && filter.has_value() && !std::regex_search(name, *filter)) {
+        return;
+      }
+      if(list_only) {
+        if(!listed_benchmarks.insert(name).second) {
+          return;
+        }
+        std::cout << name;
+        if(current_suite != nullptr) {
+          std::cout << " (" << current_suite->category << "/" << current_suite->name << ")";
+        }
+        std::cout << std::endl;
+        return;
+      }
+
+      if(!measuring_roofline_peaks &&
+          !benchmark_runs.emplace(name, args.problem_size, args.local_size, args.memory_backend).second) {
+        std::cerr << "Benchmark with name '" << name << "' has already been run with problem size "
+                  << args.problem_size << ", local size " << args.local_size << " and memory backend "
+                  << getMemoryBackendName(args.memory_backend) << "\n";
         throw std::runtime_error("Duplicate benchmark name");
       }
 
-      BenchmarkManager<Benchmark> mgr(args);
+      BenchmarkManager<Benchmark> mgr(benchmark_args);
 
 #ifdef NV_ENERGY_MEAS
       NVEnergyMeasurement nvem;
       mgr.addHook(nvem);
 #endif
 
+#ifdef __linux__
+      std::optional<PerfEventHook> perf_events;
+      if(args.cli.isArgSet("--perf-events")) {
+        perf_events.emplace(args.cli.get<std::string>("--perf-events"));
+      } else if(args.cli.isFlagSet("--perf-events")) {
+        perf_events.emplace(PerfEventHook::default_events);
+      }
+      if(perf_events.has_value()) {
+        mgr.addHook(*perf_events);
+      }
+
+      std::optional<RaplEnergyHook> rapl;
+      if(args.cli.isFlagSet("--rapl") || args.cli.isArgSet("--rapl-root")) {
+        rapl.emplace(args.cli.getOrDefault<std::string>("--rapl-root", RaplEnergyHook::default_root));
+        if constexpr(detail::BenchmarkTraits<Benchmark>::hasGetThroughputMetric) {
+          rapl->setThroughputMetric(Benchmark::getThroughputMetric(args));
+        }
+        mgr.addHook(*rapl);
+      }
+
+      std::optional<MemoryFootprintHook> memory_footprint;
+      if(args.cli.isFlagSet("--memory-stats")) {
+        memory_footprint.emplace();
+        mgr.addHook(*memory_footprint);
+      }
+#endif
+
       mgr.run(additional_args...);
     } catch(sycl::exception& e) {
       std::cerr << "SYCL error: " << e.what() << std::endl;
     } catch(std::exception& e) {
       std::cerr << "Error: " << e.what() << std::endl;
     }
+    // Memory cached for this benchmark must not be reused by the next one
+    USMPool::trimAll();
   }
 };
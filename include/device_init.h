@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <sycl/sycl.hpp>
+
+#include "input_generator.h"
+
+/**
+ * Low-memory mode (--no-host-mirror) for benchmarks whose problem sizes approach the memory limits.
+ *
+ * Instead of initializing a full host copy of every input and transferring it, inputs are generated on
+ * the device by kernels evaluating a generator, a function object returning the value of an element from
+ * its linear index (see PrefetchedBuffer::initialize). Generators must only depend on the index, so that
+ * the host can recompute any element. Buffers are created without host memory, and verification only reads
+ * back a deterministic sample of --verification-samples output elements, which benchmarks check against
+ * values recomputed on the host from the same generators.
+ */
+class DeviceInit {
+public:
+  static constexpr std::size_t default_num_samples = 1024;
+
+  static bool isEnabled() { return config().enabled; }
+  static void setEnabled(bool enabled) { config().enabled = enabled; }
+  static void setNumSamples(std::size_t n) { config().num_samples = n; }
+
+  /**
+   * Returns sorted, distinct linear indices in [0, n) to verify: all of them if there are at most
+   * --verification-samples, otherwise the first and last index and pseudo-random ones in between.
+   */
+  static std::vector<std::size_t> getSampleIndices(std::size_t n) {
+    std::vector<std::size_t> indices;
+    if(n <= config().num_samples) {
+      indices.resize(n);
+      for(std::size_t i = 0; i < n; ++i) indices[i] = i;
+      return indices;
+    }
+    const Philox4x32 rng{0x5A3D1E};
+    indices.push_back(0);
+    indices.push_back(n - 1);
+    for(std::size_t k = 0; k < config().num_samples; ++k) {
+      const auto r = rng(k);
+      indices.push_back(((static_cast<std::uint64_t>(r[0]) << 32) | r[1]) % n);
+    }
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    return indices;
+  }
+
+private:
+  struct Config {
+    bool enabled = false;
+    std::size_t num_samples = default_num_samples;
+  };
+
+  static Config& config() {
+    static Config c;
+    return c;
+  }
+};
+
+template <int Dims, class AccType, class Generator>
+class DeviceInitKernel {
+public:
+  DeviceInitKernel(AccType acc, Generator generator) : acc{acc}, generator{generator} {}
+
+  void operator()(sycl::item<Dims> item) const { acc[item] = generator(item.get_linear_id()); }
+
+private:
+  AccType acc;
+  Generator generator;
+};
+
+template <typename T, class Generator>
+class DeviceInitUSMKernel {
+public:
+  DeviceInitUSMKernel(T* data, Generator generator) : data{data}, generator{generator} {}
+
+  void operator()(sycl::id<1> i) const { data[i[0]] = generator(i[0]); }
+
+private:
+  T* data;
+  Generator generator;
+};
+
+template <class SrcAccType, class IndexAccType, class DstAccType>
+class GatherSamplesKernel {
+public:
+  GatherSamplesKernel(SrcAccType src, IndexAccType indices, DstAccType dst) : src{src}, indices{indices}, dst{dst} {}
+
+  void operator()(sycl::id<1> i) const { dst[i] = src[indices[i]]; }
+
+private:
+  SrcAccType src;
+  IndexAccType indices;
+  DstAccType dst;
+};
+
+// Sets every element of the buffer to generator(linear index) on the device
+template <typename T, int Dims, typename Generator>
+void fillBufferOnDevice(sycl::queue& q, sycl::buffer<T, Dims>& buffer, Generator generator) {
+  q.submit([&](sycl::handler& cgh) {
+    auto acc = buffer.template get_access<sycl::access::mode::discard_write>(cgh);
+    cgh.parallel_for(buffer.get_range(), DeviceInitKernel<Dims, decltype(acc), Generator>{acc, generator});
+  });
+  q.wait_and_throw();
+}
+
+// Sets the n elements of a USM allocation to generator(linear index) on the device
+template <typename T, typename Generator>
+void fillUSMOnDevice(sycl::queue& q, T* data, std::size_t n, Generator generator) {
+  q.submit([&](sycl::handler& cgh) {
+    cgh.parallel_for(sycl::range<1>{n}, DeviceInitUSMKernel<T, Generator>{data, generator});
+  });
+  q.wait_and_throw();
+}
+
+// Copies the elements at the given linear indices of the buffer to the host, without reading back the rest
+template <typename T, int Dims>
+std::vector<T> gatherBufferSamples(
+    sycl::queue& q, sycl::buffer<T, Dims>& buffer, const std::vector<std::size_t>& indices) {
+  std::vector<T> result(indices.size());
+  if(indices.empty())
+    return result;
+
+  auto flat = buffer.template reinterpret<T, 1>(sycl::range<1>{buffer.get_range().size()});
+  {
+    sycl::buffer<std::size_t, 1> index_buf{indices.data(), sycl::range<1>{indices.size()}};
+    sycl::buffer<T, 1> result_buf{result.data(), sycl::range<1>{result.size()}};
+    q.submit([&](sycl::handler& cgh) {
+      auto src = flat.template get_access<sycl::access::mode::read>(cgh);
+      auto idx = index_buf.template get_access<sycl::access::mode::read>(cgh);
+      auto dst = result_buf.template get_access<sycl::access::mode::discard_write>(cgh);
+      cgh.parallel_for(sycl::range<1>{indices.size()},
+          GatherSamplesKernel<decltype(src), decltype(idx), decltype(dst)>{src, idx, dst});
+    });
+  }
+  return result;
+}
+
+// Copies the elements at the given linear indices of a USM allocation to the host, without reading back the rest
+template <typename T>
+std::vector<T> gatherUSMSamples(sycl::queue& q, const T* data, const std::vector<std::size_t>& indices) {
+  std::vector<T> result(indices.size());
+  if(indices.empty())
+    return result;
+
+  {
+    sycl::buffer<std::size_t, 1> index_buf{indices.data(), sycl::range<1>{indices.size()}};
+    sycl::buffer<T, 1> result_buf{result.data(), sycl::range<1>{result.size()}};
+    q.submit([&](sycl::handler& cgh) {
+      auto idx = index_buf.template get_access<sycl::access::mode::read>(cgh);
+      auto dst = result_buf.template get_access<sycl::access::mode::discard_write>(cgh);
+      cgh.parallel_for(sycl::range<1>{indices.size()},
+          GatherSamplesKernel<const T*, decltype(idx), decltype(dst)>{data, idx, dst});
+    });
+  }
+  return result;
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "command_line.h"
+
+namespace detail {
+
+#ifdef __linux__
+// CPUs and nodes are stored in cpu_set_t and node masks of at most this many bits
+constexpr int max_cpu_list_entry = CPU_SETSIZE;
+#else
+constexpr int max_cpu_list_entry = 1024;
+#endif
+
+// Parses a Linux CPU or node list such as "0-3,8,10-11"
+inline std::vector<int> parseCpuList(const std::string& s) {
+  std::vector<int> result;
+  std::stringstream istr(s);
+  std::string entry;
+  while(std::getline(istr, entry, ',')) {
+    if(entry.empty())
+      continue;
+    const auto dash = entry.find('-');
+    const int first = std::stoi(entry.substr(0, dash));
+    const int last = dash == std::string::npos ? first : std::stoi(entry.substr(dash + 1));
+    if(first < 0 || last < first || last >= max_cpu_list_entry)
+      throw std::invalid_argument{"Invalid CPU or node list entry: " + entry};
+    for(int i = first; i <= last; ++i) result.push_back(i);
+  }
+  return result;
+}
+
+// Formats a sorted list of CPUs or nodes as a Linux CPU list, e.g. "0-3,8"
+inline std::string formatCpuList(const std::vector<int>& list, const char* separator = ",") {
+  std::stringstream ostr;
+  for(std::size_t i = 0; i < list.size();) {
+    std::size_t j = i;
+    while(j + 1 < list.size() && list[j + 1] == list[j] + 1) ++j;
+    if(i != 0)
+      ostr << separator;
+    ostr << list[i];
+    if(j != i)
+      ostr << "-" << list[j];
+    i = j + 1;
+  }
+  return ostr.str();
+}
+
+} // namespace detail
+
+/**
+ * Controls where the benchmark process runs and where its host memory is placed, which matters
+ * a lot when benchmarking CPU devices:
+ *
+ * --cpu-affinity=<cpu-list> pins the process, including all threads created later such as the worker
+ * threads of the SYCL runtime, to the given CPUs.
+ *
+ * --numa-policy=<policy> selects the placement of host memory:
+ * - default: the OS default, i.e. pages are placed on the node of the thread touching them first
+ * - first-touch: like default, but host buffers allocated through HostVector are first touched in
+ *   parallel by threads spread over all CPUs of the affinity mask, so that they are distributed
+ *   over the NUMA nodes instead of ending up on the node of the thread initializing them
+ * - interleave[:<node-list>]: interleave all memory of the process over the given (default: all) nodes
+ * - bind:<node-list>: allocate all memory of the process on the given nodes
+ *
+ * The used placement and the topology are reported with every result, so that runs are reproducible.
+ * Must be applied before any SYCL queue is created.
+ */
+class HostPlacement {
+public:
+  static HostPlacement& get() {
+    static HostPlacement placement;
+    return placement;
+  }
+
+  void apply(const CommandLine& cli) {
+    policy = cli.getOrDefault<std::string>("--numa-policy", "default");
+#ifdef __linux__
+    if(cli.isArgSet("--cpu-affinity")) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for(int cpu : detail::parseCpuList(cli.get<std::string>("--cpu-affinity"))) CPU_SET(cpu, &set);
+      if(sched_setaffinity(0, sizeof(set), &set) != 0)
+        throw std::runtime_error{"Could not set CPU affinity: " + std::string{std::strerror(errno)}};
+    }
+
+    const auto colon = policy.find(':');
+    const std::string mode = policy.substr(0, colon);
+    const std::string nodes = colon == std::string::npos ? "" : policy.substr(colon + 1);
+    if(mode == "interleave") {
+      setMemoryPolicy(MPOL_INTERLEAVE, nodes.empty() ? getNumaNodes() : detail::parseCpuList(nodes));
+    } else if(mode == "bind") {
+      if(nodes.empty())
+        throw std::invalid_argument{"--numa-policy=bind requires a node list, e.g. bind:0"};
+      setMemoryPolicy(MPOL_BIND, detail::parseCpuList(nodes));
+    } else if(mode != "default" && mode != "first-touch") {
+      throw std::invalid_argument{"Unknown NUMA policy: " + policy};
+    }
+#else
+    if(cli.isArgSet("--cpu-affinity") || policy != "default")
+      throw std::invalid_argument{"--cpu-affinity and --numa-policy are only supported on Linux"};
+#endif
+  }
+
+  bool isParallelFirstTouch() const { return policy == "first-touch"; }
+
+  const std::string& getPolicy() const { return policy; }
+
+  // CPUs the process is allowed to run on
+  std::vector<int> getAffinity() const {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if(sched_getaffinity(0, sizeof(set), &set) == 0) {
+      for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if(CPU_ISSET(cpu, &set))
+          cpus.push_back(cpu);
+      }
+    }
+#endif
+    if(cpus.empty()) {
+      for(unsigned i = 0; i < std::max(1u, std::thread::hardware_concurrency()); ++i)
+        cpus.push_back(static_cast<int>(i));
+    }
+    return cpus;
+  }
+
+  // NUMA nodes of the system, empty if unknown
+  static std::vector<int> getNumaNodes() {
+    std::vector<int> nodes;
+#ifdef __linux__
+    std::ifstream online{"/sys/devices/system/node/online"};
+    std::string list;
+    if(std::getline(online, list))
+      nodes = detail::parseCpuList(list);
+#endif
+    return nodes;
+  }
+
+  /**
+   * Touches the memory in [data, data + bytes) in parallel, with one thread per CPU of the affinity mask
+   * pinned to its CPU and touching a contiguous chunk, so that pages are placed close to the CPU that
+   * processes the corresponding part of the data in a statically partitioned parallel loop.
+   */
+  void firstTouch(void* data, std::size_t bytes) const {
+    const auto cpus = getAffinity();
+    const std::size_t num_threads = std::min(cpus.size(), std::max<std::size_t>(1, bytes / min_bytes_per_thread));
+    if(num_threads <= 1) {
+      std::memset(data, 0, bytes);
+      return;
+    }
+
+    std::vector<std::thread> threads;
+    const std::size_t chunk = (bytes + num_threads - 1) / num_threads;
+    for(std::size_t t = 0; t < num_threads; ++t) {
+      threads.emplace_back([=]() {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpus[t], &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+        const std::size_t begin = std::min(bytes, t * chunk);
+        const std::size_t end = std::min(bytes, begin + chunk);
+        std::memset(static_cast<char*>(data) + begin, 0, end - begin);
+      });
+    }
+    for(auto& t : threads) t.join();
+  }
+
+  // Lists are separated by ';' instead of ',', so that the values do not break the CSV output
+  void emitResults(ResultConsumer& consumer) const {
+    consumer.consumeResult("cpu-affinity", detail::formatCpuList(getAffinity(), ";"));
+    const auto nodes = getNumaNodes();
+    consumer.consumeResult("numa-nodes", nodes.empty() ? "N/A" : detail::formatCpuList(nodes, ";"));
+    std::string reported_policy = policy;
+    std::replace(reported_policy.begin(), reported_policy.end(), ',', ';');
+    consumer.consumeResult("numa-policy", reported_policy);
+  }
+
+private:
+  static constexpr std::size_t min_bytes_per_thread = 1 << 20;
+
+  std::string policy = "default";
+
+#ifdef __linux__
+  static void setMemoryPolicy(int mode, const std::vector<int>& nodes) {
+    if(nodes.empty())
+      throw std::runtime_error{"Could not determine NUMA nodes"};
+    constexpr std::size_t bits_per_word = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(*std::max_element(nodes.begin(), nodes.end()) / bits_per_word + 1, 0);
+    for(int node : nodes) mask[node / bits_per_word] |= 1ul << (node % bits_per_word);
+    if(syscall(SYS_set_mempolicy, mode, mask.data(), mask.size() * bits_per_word + 1) != 0)
+      throw std::runtime_error{"Could not set NUMA policy: " + std::string{std::strerror(errno)}};
+  }
+#endif
+};
+
+/**
+ * Allocator for host buffers that applies the parallel first-touch placement of
+ * --numa-policy=first-touch. With other policies, it behaves like std::allocator.
+ */
+template <typename T>
+class FirstTouchAllocator {
+public:
+  using value_type = T;
+
+  FirstTouchAllocator() = default;
+  template <typename U>
+  FirstTouchAllocator(const FirstTouchAllocator<U>&) {}
+
+  T* allocate(std::size_t n) {
+    T* data = std::allocator<T>{}.allocate(n);
+    if(HostPlacement::get().isParallelFirstTouch())
+      HostPlacement::get().firstTouch(data, n * sizeof(T));
+    return data;
+  }
+
+  void deallocate(T* p, std::size_t n) { std::allocator<T>{}.deallocate(p, n); }
+
+  template <typename U>
+  bool operator==(const FirstTouchAllocator<U>&) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const FirstTouchAllocator<U>&) const {
+    return false;
+  }
+};
+
+// Host-side vector whose pages are placed according to --numa-policy
+template <typename T>
+using HostVector = std::vector<T, FirstTouchAllocator<T>>;
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "input_generator.h"
+
+/**
+ * Read-only 24 bit BGR image with rows ordered from top to bottom. For bottom-up BMP files, row_stride
+ * is negative, so that rows can be accessed in the file without copying.
+ */
+struct SourceImage {
+  std::shared_ptr<const void> owner;
+  const std::uint8_t* top_row = nullptr;
+  std::ptrdiff_t row_stride = 0;
+  std::size_t width = 0;
+  std::size_t height = 0;
+
+  const std::uint8_t* row(std::size_t r) const { return top_row + static_cast<std::ptrdiff_t>(r) * row_stride; }
+};
+
+/**
+ * Provides the input images of the image processing benchmarks (median, sobel, sobel5, sobel7).
+ *
+ * The image is read from --image=<file>, an uncompressed 24 bit BMP file, or otherwise from share/Brommy.bmp
+ * next to or one level above the directory of the executable or the working directory. BMP files are
+ * memory-mapped and decoded directly into the destination, without intermediate copies. If no file is
+ * found or --image=synthetic is given, a procedural image is generated instead. Like other inputs built
+ * with generateInput(), it only depends on the pixel coordinates and is identical on all machines.
+ *
+ * The image is loaded once per process and repeated to fill size x size destinations in parallel on
+ * the NativeThreadPool, so that setup() stays cheap even for very large problem sizes.
+ */
+class ImageSource {
+public:
+  static constexpr std::size_t synthetic_image_size = 512;
+
+  static ImageSource& get() {
+    static ImageSource source;
+    return source;
+  }
+
+  void setPath(const std::string& filename) {
+    path = filename;
+    image.reset();
+  }
+
+  /**
+   * Fills dst[i * size + j] with convert(r, g, b) of pixel (i % height, j % width) of the image, i.e.
+   * repeats the image in both dimensions. Every row converts one copy of its source row and then
+   * replicates it with doubling block copies.
+   */
+  template <typename T, typename Convert>
+  void loadTiled(T* dst, std::size_t size, Convert&& convert) {
+    const SourceImage& source = getImage();
+    const std::size_t tile_width = std::min(source.width, size);
+    const auto fill_rows = [&](std::size_t begin, std::size_t end) {
+      for(std::size_t i = begin; i < end; ++i) {
+        T* row = dst + i * size;
+        const std::uint8_t* pixels = source.row(i % source.height);
+        for(std::size_t j = 0; j < tile_width; ++j)
+          row[j] = convert(pixels[3 * j + 2], pixels[3 * j + 1], pixels[3 * j]);
+        for(std::size_t filled = tile_width; filled < size;) {
+          const std::size_t n = std::min(filled, size - filled);
+          std::copy_n(row, n, row + filled);
+          filled += n;
+        }
+      }
+    };
+    if(size * size < min_parallel_input_size) {
+      fill_rows(0, size);
+    } else {
+      NativeThreadPool::get().parallelFor(size, fill_rows);
+    }
+  }
+
+private:
+  std::string path;
+  std::optional<SourceImage> image;
+
+  const SourceImage& getImage() {
+    if(image.has_value())
+      return *image;
+
+    if(path == "synthetic") {
+      image = generateSynthetic();
+    } else if(!path.empty()) {
+      image = mapBitmap(path);
+      if(!image.has_value()) {
+        std::cerr << "Could not load image " << path << ", using a synthetic image instead" << std::endl;
+        image = generateSynthetic();
+      }
+    } else {
+      for(const auto& candidate : getDefaultPaths()) {
+        image = mapBitmap(candidate);
+        if(image.has_value())
+          break;
+      }
+      if(!image.has_value()) {
+        std::cerr << "share/Brommy.bmp not found, using a synthetic image (see --image)" << std::endl;
+        image = generateSynthetic();
+      }
+    }
+    return *image;
+  }
+
+  static std::vector<std::string> getDefaultPaths() {
+    std::vector<std::string> dirs;
+#ifdef __linux__
+    char exe[PATH_MAX];
+    const ssize_t length = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if(length > 0) {
+      const std::string exe_path{exe, static_cast<std::size_t>(length)};
+      const std::string exe_dir = exe_path.substr(0, exe_path.find_last_of('/'));
+      dirs.push_back(exe_dir + "/..");
+      dirs.push_back(exe_dir + "/../..");
+    }
+#endif
+    dirs.push_back("..");
+    dirs.push_back("../..");
+    dirs.push_back(".");
+
+    std::vector<std::string> result;
+    for(const auto& dir : dirs) result.push_back(dir + "/share/Brommy.bmp");
+    return result;
+  }
+
+  template <typename T>
+  static T readLittleEndian(const std::uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+  }
+
+  // Maps an uncompressed 24 bit BMP file; returns nullopt for missing or unsupported files
+  static std::optional<SourceImage> mapBitmap(const std::string& filename) {
+    std::shared_ptr<const void> owner;
+    const std::uint8_t* data = nullptr;
+    std::size_t file_size = 0;
+#ifdef __linux__
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+      return std::nullopt;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size == 0) {
+      close(fd);
+      return std::nullopt;
+    }
+    file_size = static_cast<std::size_t>(st.st_size);
+    void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mapping == MAP_FAILED)
+      return std::nullopt;
+    owner = std::shared_ptr<const void>{
+        mapping, [file_size](const void* p) { munmap(const_cast<void*>(p), file_size); }};
+    data = static_cast<const std::uint8_t*>(mapping);
+#else
+    std::ifstream input{filename, std::ios::binary};
+    if(!input)
+      return std::nullopt;
+    auto contents = std::make_shared<std::vector<std::uint8_t>>(
+        std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{});
+    file_size = contents->size();
+    data = contents->data();
+    owner = contents;
+#endif
+
+    // 14 byte file header followed by a BITMAPINFOHEADER (or a later version of it)
+    constexpr std::size_t headers_size = 14 + 40;
+    if(file_size < headers_size || data[0] != 'B' || data[1] != 'M') {
+      std::cerr << filename << " is not in proper BMP format." << std::endl;
+      return std::nullopt;
+    }
+    const auto pixel_offset = readLittleEndian<std::uint32_t>(data + 10);
+    const auto width = readLittleEndian<std::int32_t>(data + 18);
+    const auto height = readLittleEndian<std::int32_t>(data + 22);
+    const auto bits_per_pixel = readLittleEndian<std::uint16_t>(data + 28);
+    const auto compression = readLittleEndian<std::uint32_t>(data + 30);
+    if(bits_per_pixel != 24 || compression != 0 || width <= 0 || height == 0) {
+      std::cerr << filename << " is not an uncompressed 24 bit BMP file." << std::endl;
+      return std::nullopt;
+    }
+
+    SourceImage result;
+    result.owner = owner;
+    result.width = static_cast<std::size_t>(width);
+    result.height = static_cast<std::size_t>(height < 0 ? -static_cast<std::int64_t>(height) : height);
+    // Rows are padded to a multiple of 4 bytes
+    const std::size_t stride = (3 * result.width + 3) & ~std::size_t{3};
+    if(pixel_offset > file_size || (file_size - pixel_offset) / stride < result.height) {
+      std::cerr << filename << " is truncated." << std::endl;
+      return std::nullopt;
+    }
+    // Positive heights denote bottom-up images
+    if(height > 0) {
+      result.top_row = data + pixel_offset + (result.height - 1) * stride;
+      result.row_stride = -static_cast<std::ptrdiff_t>(stride);
+    } else {
+      result.top_row = data + pixel_offset;
+      result.row_stride = static_cast<std::ptrdiff_t>(stride);
+    }
+    return result;
+  }
+
+  /**
+   * Checkerboard of 32 x 32 blocks in red, a diagonal gradient in green and concentric rings in blue,
+   * with some counter-based noise on top, so that the filters see both edges and smooth regions.
+   */
+  static SourceImage generateSynthetic() {
+    constexpr std::size_t n = synthetic_image_size;
+    auto pixels = std::make_shared<std::vector<std::uint8_t>>(3 * n * n);
+    const Philox4x32 rng{0xB5};
+    generateInput(pixels->data(), pixels->size(), [&](std::size_t k) {
+      const std::size_t i = k / 3 / n;
+      const std::size_t j = k / 3 % n;
+      const auto noise = static_cast<int>(rng(i * n + j)[k % 3] & 31) - 16;
+      int value;
+      if(k % 3 == 2) {
+        value = ((i / 32 + j / 32) % 2 == 0) ? 200 : 55;
+      } else if(k % 3 == 1) {
+        value = static_cast<int>((i + j) * 255 / (2 * n - 2));
+      } else {
+        const auto di = static_cast<std::int64_t>(i) - static_cast<std::int64_t>(n / 2);
+        const auto dj = static_cast<std::int64_t>(j) - static_cast<std::int64_t>(n / 2);
+        value = ((di * di + dj * dj) / 1024) % 2 == 0 ? 230 : 25;
+      }
+      return static_cast<std::uint8_t>(std::clamp(value + noise, 0, 255));
+    });
+
+    SourceImage result;
+    result.owner = pixels;
+    result.top_row = pixels->data();
+    result.row_stride = static_cast<std::ptrdiff_t>(3 * n);
+    result.width = n;
+    result.height = n;
+    return result;
+  }
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "native_parallel.h"
+
+/**
+ * Counter-based Philox4x32-10 random number generator (Salmon et al., "Parallel Random Numbers: As Easy
+ * as 1, 2, 3", SC 2011). Every output block is a pure function of the key (the seed) and a 128 bit
+ * counter, so the i-th random value can be computed independently of all others. Inputs generated
+ * with it are therefore identical regardless of the number of threads and across machines.
+ */
+class Philox4x32 {
+public:
+  using Block = std::array<std::uint32_t, 4>;
+
+  Philox4x32(std::uint64_t seed)
+      : key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)} {}
+
+  // Returns the block for counter (index, draw), where draw allows several blocks per element
+  Block operator()(std::uint64_t index, std::uint32_t draw = 0) const {
+    Block counter{static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32), draw, 0};
+    std::uint32_t k0 = key[0];
+    std::uint32_t k1 = key[1];
+    for(int round = 0; round < 10; ++round) {
+      const std::uint64_t p0 = static_cast<std::uint64_t>(m0) * counter[0];
+      const std::uint64_t p1 = static_cast<std::uint64_t>(m1) * counter[2];
+      counter = {static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^ k0, static_cast<std::uint32_t>(p1),
+          static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^ k1, static_cast<std::uint32_t>(p0)};
+      k0 += w0;
+      k1 += w1;
+    }
+    return counter;
+  }
+
+  // Uniformly distributed double in [0, 1) from two 32 bit words, using 53 random bits
+  static double toUnitDouble(std::uint32_t hi, std::uint32_t lo) {
+    const std::uint64_t bits = ((static_cast<std::uint64_t>(hi) << 32) | lo) >> 11;
+    return static_cast<double>(bits) * 0x1.0p-53;
+  }
+
+private:
+  static constexpr std::uint32_t m0 = 0xD2511F53;
+  static constexpr std::uint32_t m1 = 0xCD9E8D57;
+  static constexpr std::uint32_t w0 = 0x9E3779B9;
+  static constexpr std::uint32_t w1 = 0xBB67AE85;
+
+  std::array<std::uint32_t, 2> key;
+};
+
+// Below this number of elements, inputs are generated by the calling thread only
+constexpr std::size_t min_parallel_input_size = 1 << 16;
+
+/**
+ * Sets data[i] = f(i) for all i in [0, n), in parallel on the NativeThreadPool. f must only depend on i
+ * so that the result does not depend on the number of threads. Like the first-touch placement of
+ * HostVector, the static partitioning places pages close to the threads processing them later.
+ */
+template <typename T, typename F>
+void generateInput(T* data, std::size_t n, F&& f) {
+  const auto fill = [&](std::size_t begin, std::size_t end) {
+    for(std::size_t i = begin; i < end; ++i) data[i] = f(i);
+  };
+  if(n < min_parallel_input_size) {
+    fill(0, n);
+  } else {
+    NativeThreadPool::get().parallelFor(n, fill);
+  }
+}
+
+// Uniformly distributed values in [lo, hi)
+template <typename T>
+void generateUniform(T* data, std::size_t n, T lo, T hi, std::uint64_t seed) {
+  const Philox4x32 rng{seed};
+  generateInput(data, n, [&](std::size_t i) {
+    const auto r = rng(i);
+    const double u = Philox4x32::toUnitDouble(r[0], r[1]);
+    if constexpr(std::is_integral_v<T>) {
+      const auto range = static_cast<double>(hi) - static_cast<double>(lo);
+      return static_cast<T>(lo + static_cast<T>(std::floor(u * range)));
+    } else {
+      // Rounding to T can yield hi for u close to 1, which must stay excluded
+      const T value = static_cast<T>(static_cast<double>(lo) + (static_cast<double>(hi) - lo) * u);
+      return std::min(value, std::nextafter(hi, lo));
+    }
+  });
+}
+
+// Normally distributed values using the Box-Muller transform
+template <typename T>
+void generateNormal(T* data, std::size_t n, T mean, T stddev, std::uint64_t seed) {
+  constexpr double two_pi = 6.283185307179586476925;
+  const Philox4x32 rng{seed};
+  generateInput(data, n, [&](std::size_t i) {
+    const auto r = rng(i);
+    // u1 in (0, 1] so that the logarithm is finite
+    const double u1 = 1.0 - Philox4x32::toUnitDouble(r[0], r[1]);
+    const double u2 = Philox4x32::toUnitDouble(r[2], r[3]);
+    return static_cast<T>(mean + stddev * std::sqrt(-2.0 * std::log(u1)) * std::cos(two_pi * u2));
+  });
+}
+
+/**
+ * Zipf distributed values in [0, num_values), where value k has a probability proportional to
+ * 1 / (k + 1)^exponent, for exponent > 0. Uses rejection-inversion sampling (Hoermann and Derflinger,
+ * "Rejection-inversion to generate variates from monotone discrete distributions", 1996), which needs
+ * O(1) time and memory per value independently of num_values. Rejected attempts draw the next block
+ * of the element's own counter sequence.
+ */
+template <typename T>
+void generateZipf(T* data, std::size_t n, std::size_t num_values, double exponent, std::uint64_t seed) {
+  // log(1 + x) / x and (exp(x) - 1) / x, accurate for small x
+  const auto helper1 = [](double x) {
+    return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+  };
+  const auto helper2 = [](double x) {
+    return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+  };
+  const auto h = [=](double x) { return std::exp(-exponent * std::log(x)); };
+  const auto H = [=](double x) {
+    const double log_x = std::log(x);
+    return helper2((1.0 - exponent) * log_x) * log_x;
+  };
+  const auto H_inverse = [=](double x) {
+    const double t = std::max(-1.0, x * (1.0 - exponent));
+    return std::exp(helper1(t) * x);
+  };
+
+  const double h_integral_x1 = H(1.5) - 1.0;
+  const double h_integral_n = H(static_cast<double>(num_values) + 0.5);
+  const double s = 2.0 - H_inverse(H(2.5) - h(2.0));
+  const Philox4x32 rng{seed};
+
+  generateInput(data, n, [&](std::size_t i) {
+    for(std::uint32_t draw = 0;; ++draw) {
+      const auto r = rng(i, draw);
+      const double u = h_integral_n + Philox4x32::toUnitDouble(r[0], r[1]) * (h_integral_x1 - h_integral_n);
+      const double x = H_inverse(u);
+      const double k = std::min(std::max(std::floor(x + 0.5), 1.0), static_cast<double>(num_values));
+      if(k - x <= s || u >= H(k + 0.5) - h(k))
+        return static_cast<T>(k - 1.0);
+    }
+  });
+}
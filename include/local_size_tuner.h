@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <sycl/sycl.hpp>
+
+#include "benchmark_traits.h"
+#include "command_line.h"
+#include "time_metrics.h"
+
+struct LocalSizeTuningResult {
+  std::size_t best_local_size = 0;
+  // Median run-time in seconds of every evaluated local size. Pruned candidates
+  // report the time of the runs done before they were discarded.
+  std::vector<std::pair<std::size_t, double>> response_curve;
+  bool from_cache = false;
+};
+
+/**
+ * Persists the winning local sizes of previous tuning runs in a text file, one entry per line:
+ * <device>\t<benchmark>\t<problem-size>\t<local-size>
+ * New entries are appended; when an entry occurs several times, the last one wins.
+ */
+class LocalSizeTuningCache {
+public:
+  LocalSizeTuningCache(const std::string& filename) : filename{filename} {
+    std::ifstream input{filename};
+    std::string line;
+    while(std::getline(input, line)) {
+      std::stringstream sstr{line};
+      std::string device, benchmark, problem_size, local_size;
+      if(std::getline(sstr, device, '\t') && std::getline(sstr, benchmark, '\t') &&
+          std::getline(sstr, problem_size, '\t') && std::getline(sstr, local_size)) {
+        entries[{device, benchmark, cast<std::size_t>(problem_size)}] = cast<std::size_t>(local_size);
+      }
+    }
+  }
+
+  std::optional<std::size_t> lookup(
+      const std::string& device, const std::string& benchmark, std::size_t problem_size) const {
+    const auto it = entries.find({device, benchmark, problem_size});
+    if(it == entries.end())
+      return std::nullopt;
+    return it->second;
+  }
+
+  void store(const std::string& device, const std::string& benchmark, std::size_t problem_size, std::size_t local_size) {
+    entries[{device, benchmark, problem_size}] = local_size;
+    std::ofstream output{filename, std::ios::app};
+    output << device << '\t' << benchmark << '\t' << problem_size << '\t' << local_size << std::endl;
+  }
+
+private:
+  std::string filename;
+  std::map<std::tuple<std::string, std::string, std::size_t>, std::size_t> entries;
+};
+
+/**
+ * Searches the local size that minimizes the run-time of a benchmark.
+ *
+ * Candidates are the powers of two of at least --autotune-min-local (default 2, as tree reductions
+ * cannot make progress with a single work item per group) that divide the problem size and do not
+ * exceed the maximum work group size of the device. Benchmarks reject other unsupported local sizes
+ * by throwing from setup() or run(), which skips the candidate. Benchmarks opt into tuning by providing
+ *
+ *   static std::size_t getLocalMemoryUsage(const BenchmarkArgs& args);
+ *
+ * which returns the local memory in bytes required per work group for args.local_size.
+ * Candidates exceeding the local memory of the device are skipped.
+ *
+ * Every candidate is set up once, run once to warm up (e.g. JIT compilation) and then measured
+ * up to --autotune-runs times. A candidate is discarded early as soon as one of its runs is
+ * slower than --autotune-prune-factor times the best median found so far.
+ */
+template <class Benchmark>
+class LocalSizeTuner {
+public:
+  LocalSizeTuner(const BenchmarkArgs& args) : args(args) {}
+
+  template <typename... Args>
+  LocalSizeTuningResult tune(const std::string& benchmark_name, Args&&... additionalArgs) {
+    const auto device = args.device_queue.get_device();
+    const auto device_name = device.get_info<sycl::info::device::name>();
+
+    std::optional<LocalSizeTuningCache> cache;
+    if(args.cli.isArgSet("--autotune-cache")) {
+      cache.emplace(args.cli.get<std::string>("--autotune-cache"));
+      if(const auto cached = cache->lookup(device_name, benchmark_name, args.problem_size)) {
+        LocalSizeTuningResult result;
+        result.best_local_size = *cached;
+        result.from_cache = true;
+        return result;
+      }
+    }
+
+    const std::size_t num_runs = args.cli.getOrDefault<std::size_t>("--autotune-runs", 3);
+    const double prune_factor = args.cli.getOrDefault<double>("--autotune-prune-factor", 1.5);
+
+    LocalSizeTuningResult result;
+    double best_time = std::numeric_limits<double>::infinity();
+
+    for(const std::size_t local_size : getCandidates(device)) {
+      BenchmarkArgs candidate_args = args;
+      candidate_args.local_size = local_size;
+
+      std::vector<double> times;
+      try {
+        Benchmark b(candidate_args, additionalArgs...);
+        b.setup();
+        args.device_queue.wait_and_throw();
+
+        // Warmup run, not measured
+        runOnce(b);
+
+        for(std::size_t run = 0; run < num_runs; ++run) {
+          times.push_back(runOnce(b));
+          if(times.back() > prune_factor * best_time)
+            break;
+        }
+      } catch(std::exception& e) {
+        // SYCL errors, or benchmarks rejecting the local size (e.g. std::invalid_argument)
+        std::cerr << "Skipping local size " << local_size << " during tuning: " << e.what() << std::endl;
+        continue;
+      }
+
+      std::sort(times.begin(), times.end());
+      const double median = detail::median(times);
+      result.response_curve.emplace_back(local_size, median);
+      if(median < best_time) {
+        best_time = median;
+        result.best_local_size = local_size;
+      }
+    }
+
+    if(result.response_curve.empty())
+      throw std::runtime_error{"No valid local size found during tuning"};
+
+    if(cache.has_value())
+      cache->store(device_name, benchmark_name, args.problem_size, result.best_local_size);
+
+    return result;
+  }
+
+private:
+  BenchmarkArgs args;
+
+  std::vector<std::size_t> getCandidates(const sycl::device& device) const {
+    const std::size_t max_work_group_size = device.get_info<sycl::info::device::max_work_group_size>();
+    const std::size_t local_mem_size = device.get_info<sycl::info::device::local_mem_size>();
+    const std::size_t min_local_size = args.cli.getOrDefault<std::size_t>("--autotune-min-local", 2);
+
+    std::vector<std::size_t> candidates;
+    for(std::size_t local_size = 1; local_size <= std::min(max_work_group_size, args.problem_size); local_size *= 2) {
+      if(local_size < min_local_size || args.problem_size % local_size != 0)
+        continue;
+
+      BenchmarkArgs candidate_args = args;
+      candidate_args.local_size = local_size;
+      if(Benchmark::getLocalMemoryUsage(candidate_args) > local_mem_size)
+        continue;
+
+      candidates.push_back(local_size);
+    }
+    return candidates;
+  }
+
+  // Returns the run-time of a single run in seconds
+  double runOnce(Benchmark& b) {
+    std::vector<sycl::event> events;
+    const auto before = std::chrono::high_resolution_clock::now();
+    if constexpr(detail::BenchmarkTraits<Benchmark>::supportsQueueProfiling) {
+      b.run(events);
+    } else {
+      b.run();
+    }
+    args.device_queue.wait_and_throw();
+    const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - before;
+    return elapsed.count();
+  }
+};
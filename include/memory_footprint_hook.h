@@ -0,0 +1,114 @@
+#pragma once
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+#include "allocation_tracker.h"
+#include "benchmark_hook.h"
+#include "time_metrics.h"
+
+/**
+ * Records the memory footprint of a benchmark:
+ *
+ * - peak-rss: peak resident set size of the process (VmHWM) while the benchmark was running. Where
+ *   supported, the peak is reset at the start of every benchmark via /proc/self/clear_refs,
+ *   otherwise it is the peak since the start of the process.
+ * - setup-{minor,major}-page-faults and run-{minor,major}-page-faults: median number of page faults
+ *   per setup() and per timed region (getrusage).
+ * - peak-<kind>-bytes: peak number of bytes allocated through PrefetchedBuffer (kind buffer) and
+ *   USMBuffer (kinds usm-device, usm-host and usm-shared), as counted by the AllocationTracker.
+ */
+class MemoryFootprintHook : public BenchmarkHook {
+public:
+  void atInit() override {
+    // Writing 5 to clear_refs resets the peak RSS (Linux >= 4.0)
+    std::ofstream clear_refs{"/proc/self/clear_refs"};
+    clear_refs << "5" << std::flush;
+
+    AllocationTracker::get().resetPeaks();
+    setup_faults.clear();
+    run_faults.clear();
+  }
+
+  void preSetup() override { begin = getPageFaults(); }
+  void postSetup() override { setup_faults.push_back(getPageFaults() - begin); }
+
+  void preKernel() override { begin = getPageFaults(); }
+  void postKernel() override { run_faults.push_back(getPageFaults() - begin); }
+
+  void emitResults(ResultConsumer& consumer) override {
+    if(const auto peak_rss = readStatusKiB("VmHWM:")) {
+      consumer.consumeResult("peak-rss", std::to_string(*peak_rss / 1024.0), "MiB");
+    } else {
+      consumer.consumeResult("peak-rss", "N/A");
+    }
+
+    emitFaults(consumer, "setup", setup_faults);
+    emitFaults(consumer, "run", run_faults);
+
+    const auto& tracker = AllocationTracker::get();
+    for(int kind = 0; kind < AllocationTracker::num_kinds; ++kind) {
+      const auto k = static_cast<AllocationTracker::Kind>(kind);
+      consumer.consumeResult(std::string{"peak-"} + AllocationTracker::getName(k) + "-bytes",
+          std::to_string(tracker.getPeak(k)), "B");
+    }
+  }
+
+private:
+  struct PageFaults {
+    long minor = 0;
+    long major = 0;
+
+    PageFaults operator-(const PageFaults& other) const { return {minor - other.minor, major - other.major}; }
+  };
+
+  PageFaults begin;
+  std::vector<PageFaults> setup_faults;
+  std::vector<PageFaults> run_faults;
+
+  static PageFaults getPageFaults() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return {usage.ru_minflt, usage.ru_majflt};
+  }
+
+  // Reads a value in KiB, e.g. "VmHWM:", from /proc/self/status
+  static std::optional<double> readStatusKiB(const std::string& key) {
+    std::ifstream status{"/proc/self/status"};
+    std::string token;
+    while(status >> token) {
+      if(token == key) {
+        double value;
+        if(status >> value)
+          return value;
+        return std::nullopt;
+      }
+    }
+    return std::nullopt;
+  }
+
+  static void emitFaults(ResultConsumer& consumer, const std::string& phase, const std::vector<PageFaults>& faults) {
+    if(faults.empty()) {
+      consumer.consumeResult(phase + "-minor-page-faults", "N/A");
+      consumer.consumeResult(phase + "-major-page-faults", "N/A");
+      return;
+    }
+    std::vector<double> minor, major;
+    for(const auto& f : faults) {
+      minor.push_back(static_cast<double>(f.minor));
+      major.push_back(static_cast<double>(f.major));
+    }
+    std::sort(minor.begin(), minor.end());
+    std::sort(major.begin(), major.end());
+    consumer.consumeResult(phase + "-minor-page-faults", std::to_string(detail::median(minor)));
+    consumer.consumeResult(phase + "-major-page-faults", std::to_string(detail::median(major)));
+  }
+};
+
+#endif
@@ -2,6 +2,9 @@
 #include "common.h"
 #include <memory>
 
+#include "allocation_tracker.h"
+#include "device_init.h"
+#include "usm_pool.h"
 #include "utils.h"
 
 
@@ -40,22 +43,34 @@ template <class T, int Dimensions = 1>
 class PrefetchedBuffer {
 public:
   void initialize(sycl::queue& q, sycl::range<Dimensions> r) {
-    buff = std::make_shared<sycl::buffer<T, Dimensions>>(r);
+    buff = makeBuffer(r);
     forceDataAllocation(q, *buff);
   }
 
   void initialize(sycl::queue& q, T* data, sycl::range<Dimensions> r) {
-    buff = std::make_shared<sycl::buffer<T, Dimensions>>(data, r);
+    buff = makeBuffer(data, r);
     buff->set_write_back(false);
     forceDataTransfer(q, *buff);
   }
 
   void initialize(sycl::queue& q, const T* data, sycl::range<Dimensions> r) {
-    buff = std::make_shared<sycl::buffer<T, Dimensions>>(data, r);
+    buff = makeBuffer(data, r);
     buff->set_write_back(false);
     forceDataTransfer(q, *buff);
   }
 
+  // Generates the contents on the device from generator(linear index), without host memory (see DeviceInit)
+  template <typename Generator>
+  void initialize(sycl::queue& q, sycl::range<Dimensions> r, Generator generator) {
+    buff = makeBuffer(r);
+    fillBufferOnDevice(q, *buff, generator);
+  }
+
+  // Reads back only the elements at the given linear indices
+  std::vector<T> gather_samples(sycl::queue& q, const std::vector<std::size_t>& indices) const {
+    return gatherBufferSamples(q, *buff, indices);
+  }
+
 
   template <sycl::access::mode mode, sycl::target target = sycl::target::device>
   auto get_access(sycl::handler& commandGroupHandler) {
@@ -89,6 +104,18 @@ public:
 private:
   // Wrap in a shared_ptr to allow default constructing this class
   std::shared_ptr<sycl::buffer<T, Dimensions>> buff;
+
+  // Creates the buffer such that its size is accounted for in the AllocationTracker while it is alive
+  template <typename... Args>
+  static std::shared_ptr<sycl::buffer<T, Dimensions>> makeBuffer(Args&&... args) {
+    auto* b = new sycl::buffer<T, Dimensions>(std::forward<Args>(args)...);
+    const std::size_t bytes = b->get_range().size() * sizeof(T);
+    AllocationTracker::get().allocate(AllocationTracker::buffer, bytes);
+    return std::shared_ptr<sycl::buffer<T, Dimensions>>(b, [bytes](sycl::buffer<T, Dimensions>* p) {
+      AllocationTracker::get().deallocate(AllocationTracker::buffer, bytes);
+      delete p;
+    });
+  }
 };
 
 
@@ -112,18 +139,26 @@ template <>
 struct usm_properties<alloc::device> {
   static constexpr bool is_device_accessible = true;
   static constexpr bool is_host_accessible = false;
+  static constexpr AllocationTracker::Kind tracker_kind = AllocationTracker::usm_device;
 };
 template <>
 struct usm_properties<alloc::host> {
   static constexpr bool is_device_accessible = true;
   static constexpr bool is_host_accessible = true;
+  static constexpr AllocationTracker::Kind tracker_kind = AllocationTracker::usm_host;
 };
 template <>
 struct usm_properties<alloc::shared> {
   static constexpr bool is_device_accessible = true;
   static constexpr bool is_host_accessible = true;
+  static constexpr AllocationTracker::Kind tracker_kind = AllocationTracker::usm_shared;
 };
 
+// USM allocation kind of a memory backend; buffer is mapped to device but never used
+template <MemoryBackend backend>
+static constexpr alloc usm_alloc_v = backend == MemoryBackend::usm_shared ? alloc::shared
+                                     : backend == MemoryBackend::usm_host ? alloc::host
+                                                                          : alloc::device;
 
 } // namespace detail
 
@@ -138,20 +173,17 @@ protected:
   sycl::range<dim> _count;
   std::size_t total_size;
   sycl::queue* queue;
+  // Whether the allocations were obtained from the USMPool (--usm-pool)
+  bool pooled;
 
 public:
-  USMBuffer() : _data(nullptr), _host_ptr(nullptr), _count(getRange()), total_size(0), queue(nullptr) {}
+  USMBuffer()
+      : _data(nullptr), _host_ptr(nullptr), _count(getRange()), total_size(0), queue(nullptr), pooled(false) {}
 
-  ~USMBuffer() {
-    if(_data != nullptr) {
-      sycl::free(_data, *queue);
-    }
-    if constexpr(!detail::usm_properties<type>::is_host_accessible) {
-      if(_host_ptr != nullptr) {
-        sycl::free(_host_ptr, *queue);
-      }
-    }
-  }
+  USMBuffer(const USMBuffer&) = delete;
+  USMBuffer& operator=(const USMBuffer&) = delete;
+
+  ~USMBuffer() { release(); }
 
   template <typename U = T, typename = detail::has_dim_t<U, dim, 1>>
   void initialize(sycl::queue& q, size_t count) {
@@ -165,8 +197,8 @@ public:
   }
 
   void initialize(const T* data, size_t count) {
-    allocate(queue, count);
-    copy(queue, data, _data, count);
+    allocate(count);
+    copy(data, _data, count);
   }
 
   void initialize(const T* data, sycl::range<dim> count) {
@@ -174,6 +206,16 @@ public:
     copy(data, _data, count);
   }
 
+  // Allocates and copies data to the allocation, like PrefetchedBuffer::initialize
+  void initialize(sycl::queue& q, const T* data, sycl::range<dim> count) {
+    queue = &q;
+    initialize(data, count);
+    // Migrate shared allocations to the device before the first kernel touches them
+    if constexpr(type == sycl::usm::alloc::shared) {
+      queue->prefetch(_data, total_size * sizeof(T)).wait_and_throw();
+    }
+  }
+
 
   void update_host() {
     if constexpr(!detail::usm_properties<type>::is_host_accessible) {
@@ -229,12 +271,28 @@ public:
 
   auto size() const { return total_size; }
 
+  sycl::range<dim> get_range() const { return _count; }
+
 private:
   template <sycl::usm::alloc alloc_type>
   T* malloc(size_t count) {
+    AllocationTracker::get().allocate(detail::usm_properties<alloc_type>::tracker_kind, count * sizeof(T));
+    if(pooled) {
+      return static_cast<T*>(USMPool::get(*queue, alloc_type).allocate(count * sizeof(T)));
+    }
     return static_cast<T*>(sycl::malloc(count * sizeof(T), *queue, alloc_type));
   }
 
+  template <sycl::usm::alloc alloc_type>
+  void free(T* ptr, size_t count) {
+    AllocationTracker::get().deallocate(detail::usm_properties<alloc_type>::tracker_kind, count * sizeof(T));
+    if(pooled) {
+      USMPool::get(*queue, alloc_type).deallocate(ptr, count * sizeof(T));
+    } else {
+      sycl::free(ptr, *queue);
+    }
+  }
+
   auto constexpr getRange() {
     if constexpr(dim == 1) {
       return sycl::range<dim>(0);
@@ -247,18 +305,36 @@ private:
     }
   }
 
-  std::size_t inline getSize(const sycl::range<dim>& count) {
-    std::size_t total_size = 0;
-    loop<dim>([&](std::size_t val) { total_size += count[val]; });
+  std::size_t inline getSize(const sycl::range<dim>& count) const {
+    std::size_t total_size = 1;
+    loop<dim>([&](std::size_t val) { total_size *= count[val]; });
     return total_size;
   }
 
+  // Frees the current allocations, so that buffers can be initialized repeatedly. The next allocations
+  // are taken from the USMPool if it is enabled.
+  void release() {
+    if(_data != nullptr) {
+      free<type>(_data, total_size);
+    }
+    if constexpr(!detail::usm_properties<type>::is_host_accessible) {
+      if(_host_ptr != nullptr) {
+        free<sycl::usm::alloc::host>(_host_ptr, total_size);
+      }
+    }
+    _data = nullptr;
+    _host_ptr = nullptr;
+    total_size = 0;
+    pooled = USMPool::isEnabled();
+  }
+
   template <typename U = T, typename = detail::has_dim_t<U, dim, 1>>
   void allocate(size_t count) {
     assert(count >= 0 && "Cannot allocate negative num bytes");
+    release();
     _data = malloc<type>(count);
     if constexpr(!detail::usm_properties<type>::is_host_accessible) {
-      _host_ptr = static_cast<T*>(sycl::malloc_host(count * sizeof(T), *queue));
+      _host_ptr = malloc<sycl::usm::alloc::host>(count);
     } else {
       _host_ptr = _data;
     }
@@ -269,10 +345,11 @@ private:
   void allocate(const sycl::range<dim>& count) {
     loop<dim>([&](std::size_t idx) { assert(count[idx] >= 0 && "Cannot allocate negative num bytes"); });
 
+    release();
     const size_t total_size = getSize(count);
     _data = malloc<type>(total_size);
     if constexpr(!detail::usm_properties<type>::is_host_accessible) {
-      _host_ptr = static_cast<T*>(sycl::malloc_host(total_size * sizeof(T), *queue));
+      _host_ptr = malloc<sycl::usm::alloc::host>(total_size);
     } else {
       _host_ptr = _data;
     }
@@ -290,7 +367,110 @@ private:
   void copy(const T* src, T* dst, sycl::range<dim> count) const {
     loop<dim>([&](std::size_t idx) { assert(count[idx] >= 0 && "Cannot copy negative num bytes"); });
 
-    const size_t total_size = getSize(count);
-    queue->copy(src, dst, count).wait_and_throw();
+    queue->copy(src, dst, getSize(count)).wait_and_throw();
   }
+};
+
+
+/**
+ * Accessor-like view of a USM allocation, so that kernels can index buffers and USM allocations in the
+ * same way. Multi-dimensional indices are linearized in row-major order like for buffer accessors.
+ */
+template <typename T, int Dimensions, sycl::access::mode Mode>
+class USMAccessor {
+public:
+  using reference = std::conditional_t<Mode == sycl::access::mode::read, const T&, T&>;
+
+  USMAccessor(T* data, sycl::range<Dimensions> range) : data{data}, range{range} {}
+
+  reference operator[](sycl::id<Dimensions> index) const {
+    std::size_t linear = index[0];
+    for(int d = 1; d < Dimensions; ++d) linear = linear * range[d] + index[d];
+    return data[linear];
+  }
+
+  template <int D = Dimensions, std::enable_if_t<D == 1, int> = 0>
+  reference operator[](std::size_t index) const {
+    return data[index];
+  }
+
+  T* get_pointer() const { return data; }
+
+  sycl::range<Dimensions> get_range() const { return range; }
+
+private:
+  T* data;
+  sycl::range<Dimensions> range;
+};
+
+/**
+ * Device data of a benchmark in the memory model selected by --memory. Benchmarks written against
+ * DeviceData instead of PrefetchedBuffer take the backend as a template parameter and declare it as
+ *
+ *   static constexpr MemoryBackend memory_backend = Backend;
+ *
+ * and are registered for all backends with BenchmarkApp::forEachMemoryBackend.
+ *
+ * With the buffer backend, get_access() returns regular buffer accessors. With the USM backends it
+ * returns a USMAccessor, and the benchmark is submitted to the in-order queue, so that USM kernels are
+ * ordered like accessor-based ones without explicit event dependencies. In both cases, the data is on
+ * the device after initialize(), except for host USM, which the device accesses remotely. Note that with
+ * device USM, the generator overload of initialize() still allocates a host copy used for read-back.
+ */
+template <typename T, int Dimensions = 1, MemoryBackend Backend = MemoryBackend::buffer>
+class DeviceData {
+public:
+  static constexpr bool is_buffer = Backend == MemoryBackend::buffer;
+
+  void initialize(sycl::queue& q, sycl::range<Dimensions> r) { storage.initialize(q, r); }
+
+  void initialize(sycl::queue& q, T* data, sycl::range<Dimensions> r) { storage.initialize(q, data, r); }
+
+  void initialize(sycl::queue& q, const T* data, sycl::range<Dimensions> r) { storage.initialize(q, data, r); }
+
+  // Generates the contents on the device from generator(linear index) (see DeviceInit)
+  template <typename Generator>
+  void initialize(sycl::queue& q, sycl::range<Dimensions> r, Generator generator) {
+    if constexpr(is_buffer) {
+      storage.initialize(q, r, generator);
+    } else {
+      storage.initialize(q, r);
+      fillUSMOnDevice(q, storage.get(), storage.size(), generator);
+    }
+  }
+
+  // Reads back only the elements at the given linear indices
+  std::vector<T> gather_samples(sycl::queue& q, const std::vector<std::size_t>& indices) {
+    if constexpr(is_buffer) {
+      return storage.gather_samples(q, indices);
+    } else {
+      return gatherUSMSamples<T>(q, storage.get(), indices);
+    }
+  }
+
+  template <sycl::access::mode mode>
+  auto get_access(sycl::handler& commandGroupHandler) {
+    if constexpr(is_buffer) {
+      return storage.template get_access<mode>(commandGroupHandler);
+    } else {
+      return USMAccessor<T, Dimensions, mode>{storage.get(), storage.get_range()};
+    }
+  }
+
+  // For buffers a host accessor, for USM a view of the host copy of the data
+  auto get_host_access() {
+    if constexpr(is_buffer) {
+      return storage.get_host_access();
+    } else {
+      return USMAccessor<T, Dimensions, sycl::access::mode::read_write>{
+          storage.update_and_get_host_ptr(), storage.get_range()};
+    }
+  }
+
+  sycl::range<Dimensions> get_range() const { return storage.get_range(); }
+
+private:
+  std::conditional_t<is_buffer, PrefetchedBuffer<T, Dimensions>,
+      USMBuffer<T, Dimensions, detail::usm_alloc_v<Backend>>>
+      storage;
 };
\ No newline at end of file
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "host_placement.h"
+
+/**
+ * Persistent thread pool for the native CPU baselines of benchmarks (see runNative() in BenchmarkManager).
+ *
+ * One thread is started per CPU of the affinity mask (or --native-threads threads), each pinned to its
+ * CPU. parallelFor() splits the iteration space statically into contiguous chunks, one per thread, which
+ * matches the placement of host buffers by --numa-policy=first-touch. The calling thread processes the
+ * first chunk itself.
+ */
+class NativeThreadPool {
+public:
+  static NativeThreadPool& get() {
+    static NativeThreadPool pool;
+    return pool;
+  }
+
+  // Sets the number of threads; only has an effect before the first use of the pool
+  static void setNumThreads(std::size_t n) { requested_threads() = n; }
+
+  std::size_t getNumThreads() const { return workers.size() + 1; }
+
+  /**
+   * Calls f(begin, end) for contiguous chunks covering [0, n) in parallel and waits for all of them.
+   * Inner loops in f should be written such that the compiler can vectorize them.
+   */
+  template <typename F>
+  void parallelFor(std::size_t n, F&& f) {
+    const std::size_t num_threads = std::min(getNumThreads(), std::max<std::size_t>(n, 1));
+    const std::size_t chunk = (n + num_threads - 1) / std::max<std::size_t>(num_threads, 1);
+    const auto runChunk = [&, chunk](std::size_t t) {
+      const std::size_t begin = std::min(n, t * chunk);
+      const std::size_t end = std::min(n, begin + chunk);
+      if(begin < end)
+        f(begin, end);
+    };
+
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      job = runChunk;
+      active_threads = num_threads - 1;
+      pending = active_threads;
+      ++generation;
+    }
+    start_cv.notify_all();
+
+    runChunk(0);
+
+    std::unique_lock<std::mutex> lock{mutex};
+    done_cv.wait(lock, [this]() { return pending == 0; });
+    job = nullptr;
+  }
+
+  ~NativeThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      shutdown = true;
+    }
+    start_cv.notify_all();
+    for(auto& w : workers) w.join();
+  }
+
+  NativeThreadPool(const NativeThreadPool&) = delete;
+  NativeThreadPool& operator=(const NativeThreadPool&) = delete;
+
+private:
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable start_cv;
+  std::condition_variable done_cv;
+  std::function<void(std::size_t)> job;
+  std::size_t generation = 0;
+  std::size_t active_threads = 0;
+  std::size_t pending = 0;
+  bool shutdown = false;
+
+  static std::size_t& requested_threads() {
+    static std::size_t n = 0;
+    return n;
+  }
+
+  NativeThreadPool() {
+    const auto cpus = HostPlacement::get().getAffinity();
+    const std::size_t num_threads = requested_threads() > 0 ? requested_threads() : cpus.size();
+    for(std::size_t t = 1; t < num_threads; ++t) {
+      workers.emplace_back([this, t, cpu = cpus[t % cpus.size()]]() {
+        pin(cpu);
+        workerLoop(t);
+      });
+    }
+  }
+
+  static void pin(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+  }
+
+  void workerLoop(std::size_t t) {
+    std::size_t seen_generation = 0;
+    while(true) {
+      std::function<void(std::size_t)> current_job;
+      {
+        std::unique_lock<std::mutex> lock{mutex};
+        start_cv.wait(lock, [&]() { return shutdown || generation != seen_generation; });
+        if(shutdown)
+          return;
+        seen_generation = generation;
+        if(t > active_threads)
+          continue;
+        current_job = job;
+      }
+      current_job(t);
+      {
+        std::lock_guard<std::mutex> lock{mutex};
+        --pending;
+      }
+      done_cv.notify_one();
+    }
+  }
+};
@@ -0,0 +1,232 @@
+#pragma once
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <dirent.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+#include <linux/perf_event.h>
+
+#include "benchmark_hook.h"
+#include "command_line.h"
+#include "time_metrics.h"
+
+/**
+ * Collects hardware performance counters around the timed region of every run using perf_event_open.
+ *
+ * Counters are opened for every thread of the process that exists when the benchmark starts, and in
+ * inherit mode, so that threads spawned later (e.g. the worker threads of a SYCL CPU runtime) are
+ * counted as well. Values are scaled if the kernel had to multiplex the counters.
+ *
+ * For every event, the median over all runs and the individual per-run values are emitted as
+ * perf-<event>-median and perf-<event>-samples. If both cycles and instructions are measured,
+ * the instructions per cycle are reported as perf-ipc as well. With --inner-iterations, the counter
+ * values of a sample are divided by the number of inner iterations, like its run-time.
+ */
+class PerfEventHook : public BenchmarkHook {
+public:
+  // Events measured by --perf-events without an explicit list
+  static constexpr const char* default_events = "cycles,instructions,llc-misses,dtlb-misses,branch-misses";
+
+  PerfEventHook(const std::string& event_list) {
+    for(const auto& name : detail::parseCommaDelimitedList<std::string>(event_list)) {
+      Event e;
+      e.name = name;
+      if(!getEventConfig(name, e.type, e.config))
+        throw std::invalid_argument{"Unknown perf event: " + name};
+      events.push_back(e);
+    }
+  }
+
+  ~PerfEventHook() { closeCounters(); }
+
+  PerfEventHook(const PerfEventHook&) = delete;
+  PerfEventHook& operator=(const PerfEventHook&) = delete;
+
+  void atInit() override {
+    closeCounters();
+    const auto threads = getThreadIds();
+    for(auto& e : events) {
+      for(pid_t tid : threads) {
+        const int fd = openCounter(e, tid);
+        if(fd >= 0)
+          e.fds.push_back(fd);
+      }
+      if(e.fds.empty())
+        std::cerr << "Could not open perf event " << e.name << ": " << std::strerror(errno) << std::endl;
+    }
+  }
+
+  void preSetup() override {}
+  void postSetup() override {}
+
+  void setInnerIterations(std::size_t iterations) override { inner_iterations = std::max<std::size_t>(iterations, 1); }
+
+  void preKernel() override {
+    for(auto& e : events) {
+      for(int fd : e.fds) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+  }
+
+  void postKernel() override {
+    for(auto& e : events) {
+      for(int fd : e.fds) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for(auto& e : events) {
+      if(e.fds.empty())
+        continue;
+      double total = 0.0;
+      for(int fd : e.fds) total += readScaled(fd);
+      e.values.push_back(total / inner_iterations);
+    }
+  }
+
+  void emitResults(ResultConsumer& consumer) override {
+    const Event* cycles = nullptr;
+    const Event* instructions = nullptr;
+
+    for(const auto& e : events) {
+      if(e.values.empty()) {
+        consumer.consumeResult("perf-" + e.name + "-median", "N/A");
+        consumer.consumeResult("perf-" + e.name + "-samples", "N/A");
+        continue;
+      }
+      consumer.consumeResult("perf-" + e.name + "-median", std::to_string(median(e.values)));
+
+      std::stringstream samples;
+      samples << "\"";
+      for(std::size_t i = 0; i < e.values.size(); ++i) {
+        samples << std::to_string(e.values[i]);
+        if(i != e.values.size() - 1) {
+          samples << " ";
+        }
+      }
+      samples << "\"";
+      consumer.consumeResult("perf-" + e.name + "-samples", samples.str());
+
+      if(e.name == "cycles")
+        cycles = &e;
+      else if(e.name == "instructions")
+        instructions = &e;
+    }
+
+    if(cycles && instructions && cycles->values.size() == instructions->values.size()) {
+      std::vector<double> ipc;
+      for(std::size_t i = 0; i < cycles->values.size(); ++i) {
+        if(cycles->values[i] > 0.0)
+          ipc.push_back(instructions->values[i] / cycles->values[i]);
+      }
+      consumer.consumeResult("perf-ipc", ipc.empty() ? "N/A" : std::to_string(median(ipc)));
+    }
+  }
+
+private:
+  struct Event {
+    std::string name;
+    std::uint32_t type = 0;
+    std::uint64_t config = 0;
+    std::vector<int> fds;
+    std::vector<double> values;
+  };
+
+  std::vector<Event> events;
+  std::size_t inner_iterations = 1;
+
+  static bool getEventConfig(const std::string& name, std::uint32_t& type, std::uint64_t& config) {
+    const auto cacheEvent = [](std::uint64_t cache, std::uint64_t result) {
+      return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+    };
+
+    type = PERF_TYPE_HARDWARE;
+    if(name == "cycles")
+      config = PERF_COUNT_HW_CPU_CYCLES;
+    else if(name == "instructions")
+      config = PERF_COUNT_HW_INSTRUCTIONS;
+    else if(name == "branch-misses")
+      config = PERF_COUNT_HW_BRANCH_MISSES;
+    else if(name == "branches")
+      config = PERF_COUNT_HW_BRANCH_INSTRUCTIONS;
+    else if(name == "cache-references")
+      config = PERF_COUNT_HW_CACHE_REFERENCES;
+    else if(name == "cache-misses")
+      config = PERF_COUNT_HW_CACHE_MISSES;
+    else {
+      type = PERF_TYPE_HW_CACHE;
+      if(name == "llc-loads")
+        config = cacheEvent(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_ACCESS);
+      else if(name == "llc-misses")
+        config = cacheEvent(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_MISS);
+      else if(name == "l1d-misses")
+        config = cacheEvent(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS);
+      else if(name == "dtlb-misses")
+        config = cacheEvent(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_RESULT_MISS);
+      else
+        return false;
+    }
+    return true;
+  }
+
+  static std::vector<pid_t> getThreadIds() {
+    std::vector<pid_t> threads;
+    if(DIR* dir = opendir("/proc/self/task")) {
+      while(const dirent* entry = readdir(dir)) {
+        if(entry->d_name[0] != '.')
+          threads.push_back(static_cast<pid_t>(std::stol(entry->d_name)));
+      }
+      closedir(dir);
+    }
+    if(threads.empty())
+      threads.push_back(0);
+    return threads;
+  }
+
+  static int openCounter(const Event& e, pid_t tid) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = e.type;
+    attr.config = e.config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+  }
+
+  // Reads a counter, extrapolating the value if the counter was not running the whole time due to multiplexing
+  static double readScaled(int fd) {
+    std::uint64_t data[3] = {0, 0, 0};
+    if(read(fd, data, sizeof(data)) != sizeof(data) || data[2] == 0)
+      return 0.0;
+    return static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+  }
+
+  static double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return detail::median(values);
+  }
+
+  void closeCounters() {
+    for(auto& e : events) {
+      for(int fd : e.fds) close(fd);
+      e.fds.clear();
+      e.values.clear();
+    }
+  }
+};
+
+#endif
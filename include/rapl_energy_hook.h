@@ -0,0 +1,199 @@
+#pragma once
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark_hook.h"
+#include "time_metrics.h"
+
+/**
+ * Measures the energy consumed during the timed region of every run using the RAPL energy counters
+ * exposed by the Linux powercap framework, i.e. the energy_uj files of the intel-rapl zones below <root>.
+ *
+ * The root directory defaults to /sys/class/powercap and can be changed, e.g. to point to a fake
+ * directory tree for testing. Counter wraparound is handled using max_energy_range_uj; samples in which
+ * a counter without a readable max_energy_range_uj wrapped around are dropped.
+ *
+ * The total energy of all packages (the top-level zones other than psys) per run is reported as
+ * energy-median [J] and energy-samples, the average power as power-median [W]. With --inner-iterations,
+ * the energy of a sample is divided by the number of inner iterations, like its run-time. Every zone,
+ * including psys, which covers the whole platform including the packages, and sub-zones such as core
+ * or dram, is additionally reported as energy-<zone-name>-median. If the throughput metric of the
+ * benchmark is known, the work per joule is reported as energy-efficiency, e.g. in GFLOP/J.
+ */
+class RaplEnergyHook : public BenchmarkHook {
+public:
+  static constexpr const char* default_root = "/sys/class/powercap";
+
+  RaplEnergyHook(const std::string& root = default_root) {
+    for(const auto& dir : listZoneDirectories(root)) {
+      Zone z;
+      z.path = root + "/" + dir;
+      // Top-level zones are named intel-rapl:<n>, sub-zones intel-rapl:<n>:<m>
+      z.top_level = std::count(dir.begin(), dir.end(), ':') == 1;
+      z.name = readLine(z.path + "/name").value_or(dir);
+      // psys already contains the energy of the packages
+      z.in_total = z.top_level && z.name != "psys";
+      if(!z.top_level) {
+        // Sub-zone names such as "core" or "dram" repeat for every package
+        const auto parent = dir.substr(0, dir.rfind(':'));
+        z.name = readLine(root + "/" + parent + "/name").value_or(parent) + "-" + z.name;
+      }
+      z.max_energy = readValue(z.path + "/max_energy_range_uj").value_or(0);
+      if(readValue(z.path + "/energy_uj").has_value())
+        zones.push_back(z);
+    }
+    if(zones.empty())
+      std::cerr << "No RAPL energy counters found in " << root << std::endl;
+  }
+
+  void setThroughputMetric(const ThroughputMetric& metric) { throughput_metric = metric; }
+
+  void setInnerIterations(std::size_t iterations) override { inner_iterations = std::max<std::size_t>(iterations, 1); }
+
+  void atInit() override {
+    energy.clear();
+    power.clear();
+    for(auto& z : zones) z.energy.clear();
+  }
+
+  void preSetup() override {}
+  void postSetup() override {}
+
+  void preKernel() override {
+    for(auto& z : zones) z.start = readValue(z.path + "/energy_uj").value_or(0);
+    start_time = std::chrono::steady_clock::now();
+  }
+
+  void postKernel() override {
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    if(zones.empty())
+      return;
+
+    std::vector<std::uint64_t> deltas;
+    for(const auto& z : zones) {
+      const std::uint64_t end = readValue(z.path + "/energy_uj").value_or(0);
+      // The counter wraps around at max_energy_range_uj. Without it, a wrapped sample cannot be
+      // corrected and is dropped.
+      if(end < z.start && z.max_energy == 0)
+        return;
+      deltas.push_back(end >= z.start ? end - z.start : end + z.max_energy - z.start);
+    }
+
+    double total = 0.0;
+    for(std::size_t i = 0; i < zones.size(); ++i) {
+      const double joules = static_cast<double>(deltas[i]) / 1.0e6 / inner_iterations;
+      zones[i].energy.push_back(joules);
+      if(zones[i].in_total)
+        total += joules;
+    }
+    energy.push_back(total);
+    // Average power over all inner iterations, which the division by inner_iterations does not change
+    power.push_back(elapsed.count() > 0.0 ? total * inner_iterations / elapsed.count() : 0.0);
+  }
+
+  void emitResults(ResultConsumer& consumer) override {
+    if(energy.empty()) {
+      consumer.consumeResult("energy-median", "N/A");
+      consumer.consumeResult("energy-samples", "N/A");
+      consumer.consumeResult("power-median", "N/A");
+      consumer.consumeResult("energy-efficiency", "N/A");
+      return;
+    }
+
+    const double median_energy = median(energy);
+    consumer.consumeResult("energy-median", std::to_string(median_energy), "J");
+
+    std::stringstream samples;
+    samples << "\"";
+    for(std::size_t i = 0; i < energy.size(); ++i) {
+      samples << std::to_string(energy[i]);
+      if(i != energy.size() - 1) {
+        samples << " ";
+      }
+    }
+    samples << "\"";
+    consumer.consumeResult("energy-samples", samples.str());
+    consumer.consumeResult("power-median", std::to_string(median(power)), "W");
+
+    for(const auto& z : zones) {
+      consumer.consumeResult("energy-" + z.name + "-median", std::to_string(median(z.energy)), "J");
+    }
+
+    if(throughput_metric.has_value() && throughput_metric->metric > 0.0 && median_energy > 0.0) {
+      consumer.consumeResult("energy-efficiency", std::to_string(throughput_metric->metric / median_energy),
+          throughput_metric->unit + "/J");
+    } else {
+      consumer.consumeResult("energy-efficiency", "N/A");
+    }
+  }
+
+private:
+  struct Zone {
+    std::string path;
+    std::string name;
+    bool top_level = false;
+    // Whether the zone is part of the total energy
+    bool in_total = false;
+    std::uint64_t max_energy = 0;
+    std::uint64_t start = 0;
+    std::vector<double> energy;
+  };
+
+  std::vector<Zone> zones;
+  // Total energy of all packages and average power of every run
+  std::vector<double> energy;
+  std::vector<double> power;
+  std::optional<ThroughputMetric> throughput_metric;
+  std::size_t inner_iterations = 1;
+  std::chrono::steady_clock::time_point start_time;
+
+  // Returns the names of all zone directories below root, e.g. intel-rapl:0 and intel-rapl:0:1
+  static std::vector<std::string> listZoneDirectories(const std::string& root) {
+    std::vector<std::string> dirs;
+    const std::string prefix = "intel-rapl:";
+    if(DIR* dir = opendir(root.c_str())) {
+      while(const dirent* entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        if(name.compare(0, prefix.size(), prefix) == 0)
+          dirs.push_back(name);
+      }
+      closedir(dir);
+    }
+    std::sort(dirs.begin(), dirs.end());
+    return dirs;
+  }
+
+  static std::optional<std::string> readLine(const std::string& path) {
+    std::ifstream input{path};
+    std::string line;
+    if(!std::getline(input, line))
+      return std::nullopt;
+    return line;
+  }
+
+  static std::optional<std::uint64_t> readValue(const std::string& path) {
+    std::ifstream input{path};
+    std::uint64_t value;
+    if(!(input >> value))
+      return std::nullopt;
+    return value;
+  }
+
+  static double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return detail::median(values);
+  }
+};
+
+#endif
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "type_traits.h"
+
+/**
+ * Read-only view of a cached reference output. Keeps the underlying memory (a vector or a
+ * memory-mapped file) alive as long as the view exists.
+ */
+template <typename T>
+class ReferenceData {
+public:
+  ReferenceData(std::shared_ptr<const void> owner, const T* data, std::size_t size)
+      : owner{std::move(owner)}, ptr{data}, count{size} {}
+
+  const T* data() const { return ptr; }
+  std::size_t size() const { return count; }
+  const T& operator[](std::size_t i) const { return ptr[i]; }
+
+private:
+  std::shared_ptr<const void> owner;
+  const T* ptr;
+  std::size_t count;
+};
+
+/**
+ * Memoizes the golden reference outputs that benchmarks compute on the host for verification,
+ * so that expensive references (e.g. the O(n^3) polybench kernels) are computed only once per
+ * benchmark, problem size and data type instead of after every run:
+ *
+ *   const auto reference = ReferenceCache::get().getOrCompute<float>(name, size, version, [&]() {
+ *     std::vector<float> result(size);
+ *     ...
+ *     return result;
+ *   });
+ *
+ * The version identifies the generator, i.e. the input initialization and reference implementation,
+ * and must be incremented whenever these change so that stale references are not reused.
+ *
+ * References are kept in memory for the lifetime of the process, evicting the least recently used
+ * ones beyond max_memory_bytes. With --reference-cache=<dir>, they are additionally persisted in
+ * <dir> and memory-mapped by later processes. Files are written to a temporary file first and then
+ * renamed, so concurrent processes never see partially written references.
+ */
+class ReferenceCache {
+public:
+  static constexpr std::size_t max_memory_bytes = std::size_t{1} << 30;
+
+  static ReferenceCache& get() {
+    static ReferenceCache cache;
+    return cache;
+  }
+
+  void setDirectory(const std::string& dir) { directory = dir; }
+
+  template <typename T, typename Generator>
+  ReferenceData<T> getOrCompute(
+      const std::string& benchmark, std::size_t problem_size, unsigned version, Generator&& generate) {
+    const std::string key = makeKey(benchmark, problem_size, ReadableTypename<T>::name, version);
+
+    if(const auto it = entries.find(key); it != entries.end()) {
+      lru.splice(lru.begin(), lru, it->second.lru_position);
+      return makeView<T>(it->second);
+    }
+
+    std::optional<Entry> entry;
+    if(!directory.empty())
+      entry = load(getFilename(key), version, sizeof(T));
+
+    if(!entry.has_value()) {
+      auto result = std::make_shared<const std::vector<T>>(generate());
+      entry = Entry{result, result->data(), result->size() * sizeof(T)};
+      if(!directory.empty())
+        store(getFilename(key), version, sizeof(T), entry->data, entry->bytes);
+    }
+
+    lru.push_front(key);
+    entry->lru_position = lru.begin();
+    memory_bytes += entry->bytes;
+    const auto view = makeView<T>(*entry);
+    entries[key] = std::move(*entry);
+    evict();
+    return view;
+  }
+
+private:
+  struct Entry {
+    std::shared_ptr<const void> owner;
+    const void* data = nullptr;
+    std::size_t bytes = 0;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  struct FileHeader {
+    char magic[8];
+    std::uint64_t version;
+    std::uint64_t element_size;
+    std::uint64_t bytes;
+  };
+
+  static constexpr char file_magic[8] = {'S', 'B', 'R', 'E', 'F', '0', '0', '1'};
+
+  std::string directory;
+  std::map<std::string, Entry> entries;
+  // Keys ordered from most to least recently used
+  std::list<std::string> lru;
+  std::size_t memory_bytes = 0;
+
+  template <typename T>
+  static ReferenceData<T> makeView(const Entry& e) {
+    return ReferenceData<T>{e.owner, static_cast<const T*>(e.data), e.bytes / sizeof(T)};
+  }
+
+  // Drops the least recently used references, but always keeps the most recent one
+  void evict() {
+    while(memory_bytes > max_memory_bytes && lru.size() > 1) {
+      const auto it = entries.find(lru.back());
+      memory_bytes -= it->second.bytes;
+      entries.erase(it);
+      lru.pop_back();
+    }
+  }
+
+  static std::string makeKey(
+      const std::string& benchmark, std::size_t problem_size, const std::string& type, unsigned version) {
+    std::stringstream key;
+    key << benchmark << "_" << problem_size << "_" << type << "_v" << version;
+    return key.str();
+  }
+
+  std::string getFilename(const std::string& key) const {
+    std::string name = key;
+    for(char& c : name) {
+      const bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' ||
+                        c == '-' || c == '.';
+      if(!safe)
+        c = '_';
+    }
+    return directory + "/" + name + ".ref";
+  }
+
+  static std::optional<Entry> load(const std::string& filename, unsigned version, std::size_t element_size) {
+#ifdef __linux__
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+      return std::nullopt;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(FileHeader)) {
+      close(fd);
+      return std::nullopt;
+    }
+    const std::size_t file_size = static_cast<std::size_t>(st.st_size);
+    void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mapping == MAP_FAILED)
+      return std::nullopt;
+    // The mapping is released together with the last view of the reference
+    std::shared_ptr<const void> owner{mapping, [file_size](const void* p) { munmap(const_cast<void*>(p), file_size); }};
+
+    FileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    if(!isValid(header, version, element_size) || header.bytes != file_size - sizeof(FileHeader))
+      return std::nullopt;
+    return Entry{owner, static_cast<const char*>(mapping) + sizeof(FileHeader), header.bytes};
+#else
+    std::ifstream input{filename, std::ios::binary};
+    FileHeader header;
+    if(!input.read(reinterpret_cast<char*>(&header), sizeof(header)) || !isValid(header, version, element_size))
+      return std::nullopt;
+    auto data = std::make_shared<std::vector<char>>(header.bytes);
+    if(!input.read(data->data(), header.bytes))
+      return std::nullopt;
+    return Entry{data, data->data(), header.bytes};
+#endif
+  }
+
+  static bool isValid(const FileHeader& header, unsigned version, std::size_t element_size) {
+    return std::memcmp(header.magic, file_magic, sizeof(file_magic)) == 0 && header.version == version &&
+           header.element_size == element_size && header.bytes % element_size == 0;
+  }
+
+  static void store(
+      const std::string& filename, unsigned version, std::size_t element_size, const void* data, std::size_t bytes) {
+    FileHeader header;
+    std::memcpy(header.magic, file_magic, sizeof(file_magic));
+    header.version = version;
+    header.element_size = element_size;
+    header.bytes = bytes;
+
+    const std::string temporary = filename + ".tmp" + std::to_string(getProcessId());
+    {
+      std::ofstream output{temporary, std::ios::binary | std::ios::trunc};
+      output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      output.write(static_cast<const char*>(data), bytes);
+      if(!output) {
+        std::cerr << "Could not write reference cache file " << temporary << std::endl;
+        std::remove(temporary.c_str());
+        return;
+      }
+    }
+    if(std::rename(temporary.c_str(), filename.c_str()) != 0) {
+      std::cerr << "Could not write reference cache file " << filename << std::endl;
+      std::remove(temporary.c_str());
+    }
+  }
+
+  static long getProcessId() {
+#ifdef __linux__
+    return static_cast<long>(getpid());
+#else
+    return 0;
+#endif
+  }
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+class BenchmarkApp;
+
+/**
+ * A benchmark suite is the set of benchmarks implemented in one source file. Suites register
+ * themselves during static initialization using SYCL_BENCH_SUITE, and are executed by the driver in
+ * driver/sycl-bench.cpp. The driver is linked both into the per-source benchmark executables and into
+ * the combined sycl-bench executable containing all suites.
+ */
+struct BenchmarkSuite {
+  std::string name;
+  std::string category;
+  void (*run)(BenchmarkApp&);
+};
+
+class BenchmarkRegistry {
+public:
+  static BenchmarkRegistry& get() {
+    static BenchmarkRegistry registry;
+    return registry;
+  }
+
+  bool add(const BenchmarkSuite& suite) {
+    suites.push_back(suite);
+    return true;
+  }
+
+  // Returns all registered suites, ordered by category and name to be independent of static initialization order
+  std::vector<BenchmarkSuite> getSuites() const {
+    auto sorted = suites;
+    std::sort(sorted.begin(), sorted.end(), [](const BenchmarkSuite& a, const BenchmarkSuite& b) {
+      return std::tie(a.category, a.name) < std::tie(b.category, b.name);
+    });
+    return sorted;
+  }
+
+private:
+  std::vector<BenchmarkSuite> suites;
+};
+
+/**
+ * Defines and registers a benchmark suite. The body following the macro is the suite function
+ * and receives the BenchmarkApp as the parameter named by the third argument, e.g.
+ *
+ *   SYCL_BENCH_SUITE(vec_add, "single-kernel", app) {
+ *     app.run<VecAddBench<float>>();
+ *   }
+ */
+#define SYCL_BENCH_SUITE(suite_name, category, app)                                                                    \
+  static void sycl_bench_suite_##suite_name(BenchmarkApp&);                                                            \
+  [[maybe_unused]] static const bool sycl_bench_suite_##suite_name##_registered =                                      \
+      BenchmarkRegistry::get().add(BenchmarkSuite{#suite_name, category, &sycl_bench_suite_##suite_name});             \
+  static void sycl_bench_suite_##suite_name(BenchmarkApp& app)
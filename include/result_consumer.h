@@ -3,7 +3,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
 #include <fstream>
+#include <regex>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -16,6 +20,11 @@ public:
   virtual void consumeResult(
       const std::string& result_name, const std::string& result, const std::string& unit = "") = 0;
 
+  // Register a single sample of a timing or other per-run metric, as soon as it has been measured.
+  // Consumers that only report aggregated results can ignore this.
+  virtual void consumeSample(
+      const std::string& metric_name, std::size_t run, double value, const std::string& unit = "") {}
+
   // Guarantees that the results have been emitted to the output
   // as specified by the ResultConsumer implementation
   virtual void flush() = 0;
@@ -50,6 +59,17 @@ public:
   virtual void flush() override {}
 };
 
+// Drops all results, e.g. for auxiliary runs that should not be part of the output
+class NullResultConsumer : public ResultConsumer {
+public:
+  virtual void proceedToBenchmark(const std::string& name) override {}
+
+  virtual void consumeResult(
+      const std::string& result_name, const std::string& result, const std::string& unit = "") override {}
+
+  virtual void flush() override {}
+};
+
 // TODO ResultConsumer that appends to a csv
 class AppendingCsvResultConsumer : public ResultConsumer {
 public:
@@ -105,4 +125,144 @@ private:
   std::ofstream output;
 };
 
+/**
+ * Writes results as JSON Lines: one record per sample, written as soon as the sample is
+ * measured, and one summary record per benchmark containing all results with their units.
+ * Every record is written in one piece and flushed immediately, so files can be appended to by
+ * several processes and results measured before a crash are preserved.
+ *
+ *   {"type":"sample","benchmark":"...","problem-size":1024,"local-size":256,"metric":"run-time","run":0,"value":0.1,"unit":"s"}
+ *   {"type":"summary","benchmark":"...","results":{"run-time-mean":{"value":0.1,"unit":"s"},...}}
+ */
+class JsonLinesResultConsumer : public ResultConsumer {
+public:
+  JsonLinesResultConsumer(const std::string& filename) : output{filename, std::ios::app} {}
+
+  virtual void proceedToBenchmark(const std::string& benchmark_name) override {
+    currentBenchmark = benchmark_name;
+    results.clear();
+  }
+
+  virtual void consumeResult(
+      const std::string& result_name, const std::string& result, const std::string& unit = "") override {
+    results.push_back({result_name, result, unit});
+  }
+
+  virtual void consumeSample(
+      const std::string& metric_name, std::size_t run, double value, const std::string& unit = "") override {
+    std::stringstream record;
+    record << "{\"type\":\"sample\",\"benchmark\":" << quote(currentBenchmark);
+    // Identify the sweep point the sample belongs to
+    for(const auto& r : results) {
+      if(r.name == "problem-size" || r.name == "local-size" || r.name == "memory-backend")
+        record << "," << quote(r.name) << ":" << toJsonValue(r.value);
+    }
+    record << ",\"metric\":" << quote(metric_name) << ",\"run\":" << run << ",\"value\":" << toJsonNumber(value)
+           << ",\"unit\":" << quote(unit) << "}";
+    writeRecord(record.str());
+  }
+
+  virtual void flush() override {
+    if(currentBenchmark.empty())
+      return;
+
+    std::stringstream record;
+    record << "{\"type\":\"summary\",\"benchmark\":" << quote(currentBenchmark) << ",\"results\":{";
+    for(std::size_t i = 0; i < results.size(); ++i) {
+      if(i != 0)
+        record << ",";
+      record << quote(results[i].name) << ":{\"value\":" << toJsonValue(results[i].value);
+      if(!results[i].unit.empty())
+        record << ",\"unit\":" << quote(results[i].unit);
+      record << "}";
+    }
+    record << "}}";
+    writeRecord(record.str());
+
+    results.clear();
+    currentBenchmark.clear();
+  }
+
+  void discard() override {
+    assert(!currentBenchmark.empty());
+    // Samples have already been written, so mark them as belonging to a failed benchmark
+    writeRecord("{\"type\":\"discard\",\"benchmark\":" + quote(currentBenchmark) + "}");
+    results.clear();
+    currentBenchmark.clear();
+  }
+
+private:
+  struct Result {
+    std::string name;
+    std::string value;
+    std::string unit;
+  };
+
+  std::string currentBenchmark;
+  std::vector<Result> results;
+
+  std::ofstream output;
+
+  void writeRecord(const std::string& record) {
+    output << record << '\n';
+    output.flush();
+  }
+
+  static std::string quote(const std::string& s) {
+    std::string result = "\"";
+    for(char c : s) {
+      switch(c) {
+      case '"': result += "\\\""; break;
+      case '\\': result += "\\\\"; break;
+      case '\n': result += "\\n"; break;
+      case '\t': result += "\\t"; break;
+      default:
+        if(static_cast<unsigned char>(c) < 0x20) {
+          char escaped[7];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          result += escaped;
+        } else {
+          result += c;
+        }
+      }
+    }
+    return result + "\"";
+  }
+
+  static std::string toJsonNumber(double value) {
+    if(!std::isfinite(value))
+      return "null";
+    std::stringstream sstr;
+    sstr.precision(17);
+    sstr << value;
+    return sstr.str();
+  }
+
+  static bool isNumber(const std::string& s) {
+    static const std::regex json_number{R"(-?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?)"};
+    return std::regex_match(s, json_number);
+  }
+
+  // Converts a result into a typed JSON value: numbers stay numbers, "N/A" becomes null and
+  // quoted space-separated lists (e.g. the samples) become arrays.
+  static std::string toJsonValue(const std::string& value) {
+    if(value == "N/A")
+      return "null";
+    if(isNumber(value))
+      return value;
+    if(value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+      std::stringstream elements{value.substr(1, value.size() - 2)};
+      std::string element;
+      std::string array = "[";
+      while(elements >> element) {
+        if(array.size() > 1)
+          array += ",";
+        array += isNumber(element) ? element : quote(element);
+      }
+      return array + "]";
+    }
+    return quote(value);
+  }
+};
+
 #endif
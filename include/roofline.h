@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+
+#include "command_line.h"
+#include "result_consumer.h"
+
+/**
+ * Ceiling of the roofline model that a benchmark measures. Benchmarks declaring a ceiling via
+ *
+ *   static RooflineCeiling getRooflineCeiling();
+ *
+ * update the peak of the device with the performance they achieve, e.g. micro/DRAM for the memory
+ * bandwidth and micro/arith for the (single precision) compute throughput.
+ */
+enum class RooflineCeiling { none, memory_bandwidth, compute };
+
+struct RooflinePeaks {
+  // Bytes per second
+  std::optional<double> bandwidth;
+  // Floating point operations per second
+  std::optional<double> flops;
+};
+
+/**
+ * Places benchmarks on the roofline of the device. Benchmarks opt in by providing one or both of
+ *
+ *   static double getBytesMoved(const BenchmarkArgs& args);  // bytes read and written from/to global memory per run
+ *   static double getFlops(const BenchmarkArgs& args);       // floating point operations per run
+ *
+ * From these and the median run-time, the achieved bandwidth, the achieved FLOP rate and the arithmetic
+ * intensity are computed and compared against the attainable performance min(peak FLOP/s, intensity * peak
+ * bandwidth), using the peaks measured by the ceiling benchmarks on the same device.
+ *
+ * Peaks can be persisted with --roofline-peaks=<file>, one entry per line:
+ * <device>\t<bandwidth|flops>\t<value>
+ * so that executables not containing micro/DRAM and micro/arith can reuse peaks measured earlier.
+ */
+class RooflineModel {
+public:
+  static RooflineModel& get() {
+    static RooflineModel model;
+    return model;
+  }
+
+  void setPeaksFile(const std::string& filename) {
+    peaks_file = filename;
+    std::ifstream input{filename};
+    std::string line;
+    while(std::getline(input, line)) {
+      std::stringstream sstr{line};
+      std::string device, ceiling, value;
+      if(std::getline(sstr, device, '\t') && std::getline(sstr, ceiling, '\t') && std::getline(sstr, value)) {
+        updatePeak(device, ceiling == "bandwidth" ? RooflineCeiling::memory_bandwidth : RooflineCeiling::compute,
+            cast<double>(value));
+      }
+    }
+  }
+
+  // Updates the peak of the given ceiling if the value exceeds the currently known peak
+  void recordPeak(const std::string& device, RooflineCeiling ceiling, double value) {
+    if(ceiling == RooflineCeiling::none || !updatePeak(device, ceiling, value) || peaks_file.empty())
+      return;
+    std::ofstream output{peaks_file, std::ios::app};
+    output << device << '\t' << (ceiling == RooflineCeiling::memory_bandwidth ? "bandwidth" : "flops") << '\t'
+           << std::to_string(value) << std::endl;
+  }
+
+  bool hasPeaks(const std::string& device) const {
+    const auto it = peaks.find(device);
+    return it != peaks.end() && it->second.bandwidth.has_value() && it->second.flops.has_value();
+  }
+
+  /**
+   * Emits the roofline metrics of a benchmark that moved the given bytes and executed the given floating
+   * point operations in the given time per run. Unknown values are reported as N/A:
+   * achieved-bandwidth [GiB/s], achieved-flops [GFLOP/s], arithmetic-intensity [FLOP/B], the peaks of the
+   * device, the attainable performance, roofline-percent (achieved / attainable performance) and
+   * roofline-bound (memory or compute).
+   */
+  void emitResults(ResultConsumer& consumer, const std::string& device, std::optional<double> bytes,
+      std::optional<double> flops, std::optional<double> seconds) const {
+    RooflinePeaks device_peaks;
+    if(const auto it = peaks.find(device); it != peaks.end())
+      device_peaks = it->second;
+
+    std::optional<double> bandwidth, flop_rate, intensity;
+    if(seconds.has_value() && *seconds > 0.0) {
+      if(bytes.has_value())
+        bandwidth = *bytes / *seconds;
+      if(flops.has_value())
+        flop_rate = *flops / *seconds;
+    }
+    if(bytes.has_value() && flops.has_value() && *bytes > 0.0)
+      intensity = *flops / *bytes;
+
+    emit(consumer, "achieved-bandwidth", bandwidth, gib, "GiB/s");
+    emit(consumer, "achieved-flops", flop_rate, giga, "GFLOP/s");
+    emit(consumer, "arithmetic-intensity", intensity, 1.0, "FLOP/B");
+    emit(consumer, "peak-bandwidth", device_peaks.bandwidth, gib, "GiB/s");
+    emit(consumer, "peak-flops", device_peaks.flops, giga, "GFLOP/s");
+
+    // Without FLOPs, the benchmark can only be compared against the bandwidth ceiling and vice versa
+    std::optional<double> attainable, percent;
+    std::string bound = "N/A";
+    std::string attainable_unit = "GFLOP/s";
+    double attainable_scale = giga;
+    if(intensity.has_value() && device_peaks.bandwidth.has_value() && device_peaks.flops.has_value()) {
+      const double memory_ceiling = *intensity * *device_peaks.bandwidth;
+      attainable = std::min(*device_peaks.flops, memory_ceiling);
+      bound = memory_ceiling < *device_peaks.flops ? "memory" : "compute";
+      if(flop_rate.has_value())
+        percent = 100.0 * *flop_rate / *attainable;
+    } else if(!flops.has_value() && bytes.has_value() && device_peaks.bandwidth.has_value()) {
+      attainable = device_peaks.bandwidth;
+      attainable_unit = "GiB/s";
+      attainable_scale = gib;
+      bound = "memory";
+      if(bandwidth.has_value())
+        percent = 100.0 * *bandwidth / *attainable;
+    } else if(flops.has_value() && !bytes.has_value() && device_peaks.flops.has_value()) {
+      attainable = device_peaks.flops;
+      bound = "compute";
+      if(flop_rate.has_value())
+        percent = 100.0 * *flop_rate / *attainable;
+    }
+    emit(consumer, "roofline-attainable", attainable, attainable_scale, attainable_unit);
+    emit(consumer, "roofline-percent", percent, 1.0, "%");
+    consumer.consumeResult("roofline-bound", bound);
+  }
+
+private:
+  static constexpr double gib = 1024.0 * 1024.0 * 1024.0;
+  static constexpr double giga = 1.0e9;
+
+  std::map<std::string, RooflinePeaks> peaks;
+  std::string peaks_file;
+
+  bool updatePeak(const std::string& device, RooflineCeiling ceiling, double value) {
+    auto& peak = ceiling == RooflineCeiling::memory_bandwidth ? peaks[device].bandwidth : peaks[device].flops;
+    if(peak.has_value() && *peak >= value)
+      return false;
+    peak = value;
+    return true;
+  }
+
+  static void emit(ResultConsumer& consumer, const std::string& name, std::optional<double> value, double scale,
+      const std::string& unit) {
+    if(value.has_value()) {
+      consumer.consumeResult(name, std::to_string(*value / scale), unit);
+    } else {
+      consumer.consumeResult(name, "N/A");
+    }
+  }
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include <sycl/sycl.hpp>
+
+// Range of elements processed by one pass through the pipeline, in the device memory of the given slot
+struct StreamingTile {
+  std::size_t index;
+  std::size_t slot;
+  std::size_t offset;
+  std::size_t count;
+};
+
+struct StreamingStatistics {
+  std::size_t num_tiles = 0;
+  std::size_t tile_bytes = 0;
+  std::size_t depth = 0;
+  // Total time of every stage when the tiles are processed strictly one stage after another
+  double serial_h2d_time = 0.0;
+  double serial_compute_time = 0.0;
+  double serial_d2h_time = 0.0;
+
+  double getSerialTime() const { return serial_h2d_time + serial_compute_time + serial_d2h_time; }
+};
+
+/**
+ * Out-of-core execution for benchmarks whose input does not have to fit into device memory (--streaming).
+ *
+ * The input stays in (pinned) host memory and is processed in tiles, each occupying --stream-tile bytes of
+ * device memory for its inputs and outputs. Every tile is copied to the device (H2D), processed (compute)
+ * and its results are copied back (D2H). The device only
+ * holds --stream-depth slots of tile memory, and the tiles of different slots are in flight at the same
+ * time, so that the copies of some tiles overlap with the computation of others:
+ *
+ *   StreamingPipeline pipeline{num_elements, bytes_per_element};
+ *   pipeline.setStages(upload, compute, download);
+ *   pipeline.calibrate();  // in setup()
+ *   pipeline.run();        // in run()
+ *
+ * Every stage is called as stage(tile, dependency) and returns the event of its last command, which the
+ * next stage depends on. Uploads depend on the download of the previous tile of the same slot.
+ *
+ * calibrate() processes the first tile of every slot once to warm up, then all tiles strictly serially,
+ * waiting for every stage, and records the time of each stage in the statistics of the current benchmark.
+ * From these and the median run-time, BenchmarkManager reports the achieved overlap ratio: the fraction of
+ * the time that a perfect pipeline could hide behind its slowest stage which was actually hidden.
+ */
+class StreamingPipeline {
+public:
+  using Stage = std::function<sycl::event(const StreamingTile&, const sycl::event&)>;
+
+  static constexpr std::size_t default_tile_bytes = std::size_t{64} << 20;
+  static constexpr std::size_t default_depth = 3;
+
+  static bool isEnabled() { return config().enabled; }
+  static void setEnabled(bool enabled) { config().enabled = enabled; }
+  static void setTileBytes(std::size_t bytes) { config().tile_bytes = std::max<std::size_t>(bytes, 1); }
+  static void setDepth(std::size_t depth) { config().depth = std::max<std::size_t>(depth, 1); }
+
+  // Statistics recorded by calibrate() during the current benchmark
+  static const std::optional<StreamingStatistics>& getStatistics() { return config().statistics; }
+  static void resetStatistics() { config().statistics.reset(); }
+
+  // bytes_per_element: device memory needed per element of the input, including the outputs
+  StreamingPipeline(std::size_t num_elements, std::size_t bytes_per_element)
+      : num_elements{num_elements}, bytes_per_element{bytes_per_element},
+        tile_elements{std::clamp<std::size_t>(
+            config().tile_bytes / bytes_per_element, 1, std::max<std::size_t>(num_elements, 1))},
+        depth{std::min(config().depth, getNumTiles())} {}
+
+  std::size_t getTileElements() const { return tile_elements; }
+  std::size_t getNumTiles() const { return (num_elements + tile_elements - 1) / tile_elements; }
+  // Number of tiles in flight, and thus of slots of device memory
+  std::size_t getDepth() const { return std::max<std::size_t>(depth, 1); }
+
+  void setStages(Stage upload_stage, Stage compute_stage, Stage download_stage) {
+    upload = std::move(upload_stage);
+    compute = std::move(compute_stage);
+    download = std::move(download_stage);
+  }
+
+  // Warms up, then processes all tiles serially and records the stage times, once per benchmark
+  void calibrate() {
+    if(config().statistics.has_value())
+      return;
+    StreamingStatistics statistics;
+    statistics.num_tiles = getNumTiles();
+    statistics.tile_bytes = tile_elements * bytes_per_element;
+    statistics.depth = getDepth();
+
+    // Untimed warm-up of every slot, so that JIT compilation and the first touch of the device memory of
+    // the slots are not attributed to the stages
+    for(std::size_t t = 0; t < getDepth(); ++t) {
+      const StreamingTile tile = getTile(t);
+      upload(tile, sycl::event{}).wait_and_throw();
+      compute(tile, sycl::event{}).wait_and_throw();
+      download(tile, sycl::event{}).wait_and_throw();
+    }
+
+    const auto timeStage = [](double& total, auto&& submit) {
+      const auto begin = std::chrono::high_resolution_clock::now();
+      submit().wait_and_throw();
+      const auto end = std::chrono::high_resolution_clock::now();
+      total += std::chrono::duration<double>(end - begin).count();
+    };
+    for(std::size_t t = 0; t < getNumTiles(); ++t) {
+      const StreamingTile tile = getTile(t);
+      timeStage(statistics.serial_h2d_time, [&]() { return upload(tile, sycl::event{}); });
+      timeStage(statistics.serial_compute_time, [&]() { return compute(tile, sycl::event{}); });
+      timeStage(statistics.serial_d2h_time, [&]() { return download(tile, sycl::event{}); });
+    }
+    config().statistics = statistics;
+  }
+
+  // Processes all tiles with up to getDepth() tiles in flight and waits for the last one
+  void run() {
+    std::vector<sycl::event> slot_events(getDepth());
+    for(std::size_t t = 0; t < getNumTiles(); ++t) {
+      const StreamingTile tile = getTile(t);
+      // Bounds the number of tiles in flight; the device additionally orders the stages via the events
+      if(t >= getDepth())
+        slot_events[tile.slot].wait();
+      const auto uploaded = upload(tile, slot_events[tile.slot]);
+      const auto computed = compute(tile, uploaded);
+      slot_events[tile.slot] = download(tile, computed);
+    }
+    for(auto& e : slot_events) e.wait();
+  }
+
+private:
+  struct Config {
+    bool enabled = false;
+    std::size_t tile_bytes = default_tile_bytes;
+    std::size_t depth = default_depth;
+    std::optional<StreamingStatistics> statistics;
+  };
+
+  static Config& config() {
+    static Config c;
+    return c;
+  }
+
+  std::size_t num_elements;
+  std::size_t bytes_per_element;
+  std::size_t tile_elements;
+  std::size_t depth;
+  Stage upload;
+  Stage compute;
+  Stage download;
+
+  StreamingTile getTile(std::size_t t) const {
+    const std::size_t offset = t * tile_elements;
+    return StreamingTile{t, t % getDepth(), offset, std::min(tile_elements, num_elements - offset)};
+  }
+};
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <limits>
 #include <numeric>
+#include <optional>
+#include <random>
 #include <set>
 #include <sstream>
 #include <string>
@@ -28,6 +32,88 @@ struct ThroughputMetric {
   std::string unit = "";
 };
 
+namespace detail {
+
+/**
+ * Distribution-free 95% confidence interval for the median of a sorted sample, based on
+ * the normal approximation of the binomial distribution of order statistics.
+ * Returns the (lower, upper) bounds; for very small samples this degenerates to (min, max).
+ */
+inline std::pair<double, double> medianConfidenceInterval(const std::vector<double>& sorted) {
+  if(sorted.empty())
+    return {0.0, 0.0};
+  const double n = static_cast<double>(sorted.size());
+  const double half_width = 1.96 * std::sqrt(n) / 2.0;
+  // 1-based ranks of the order statistics bounding the interval
+  const double lower_rank = std::floor(n / 2.0 - half_width);
+  const double upper_rank = std::ceil(n / 2.0 + half_width) + 1.0;
+  const std::size_t lower = lower_rank < 1.0 ? 0 : static_cast<std::size_t>(lower_rank) - 1;
+  const std::size_t upper = std::min(static_cast<std::size_t>(upper_rank), sorted.size()) - 1;
+  return {sorted[lower], sorted[upper]};
+}
+
+/**
+ * Percentile p (in [0, 1]) of a sorted sample, linearly interpolating between the closest ranks.
+ * For p = 0.5, this is the median, i.e. the mean of the two middle elements for even sample sizes.
+ */
+inline double percentile(const std::vector<double>& sorted, double p) {
+  if(sorted.empty())
+    return 0.0;
+  const double rank = p * static_cast<double>(sorted.size() - 1);
+  const std::size_t lower = static_cast<std::size_t>(std::floor(rank));
+  const std::size_t upper = std::min(lower + 1, sorted.size() - 1);
+  const double fraction = rank - static_cast<double>(lower);
+  return sorted[lower] + fraction * (sorted[upper] - sorted[lower]);
+}
+
+inline double median(const std::vector<double>& sorted) { return percentile(sorted, 0.5); }
+
+// Median absolute deviation from the median
+inline double medianAbsoluteDeviation(const std::vector<double>& sorted) {
+  const double m = median(sorted);
+  std::vector<double> deviations;
+  deviations.reserve(sorted.size());
+  for(double x : sorted) deviations.push_back(std::abs(x - m));
+  std::sort(deviations.begin(), deviations.end());
+  return median(deviations);
+}
+
+/**
+ * Number of samples outside of the Tukey fences [Q1 - 1.5 IQR, Q3 + 1.5 IQR].
+ */
+inline std::size_t countOutliers(const std::vector<double>& sorted) {
+  const double q1 = percentile(sorted, 0.25);
+  const double q3 = percentile(sorted, 0.75);
+  const double iqr = q3 - q1;
+  return static_cast<std::size_t>(std::count_if(
+      sorted.begin(), sorted.end(), [&](double x) { return x < q1 - 1.5 * iqr || x > q3 + 1.5 * iqr; }));
+}
+
+/**
+ * Percentile bootstrap 95% confidence interval for the median of a sorted sample.
+ * A fixed seed is used so that repeated evaluations of the same sample give the same interval.
+ */
+inline std::pair<double, double> bootstrapMedianConfidenceInterval(
+    const std::vector<double>& sorted, std::size_t num_resamples = 1000) {
+  if(sorted.size() < 2)
+    return {median(sorted), median(sorted)};
+
+  std::mt19937_64 rng{42};
+  std::uniform_int_distribution<std::size_t> pick{0, sorted.size() - 1};
+  std::vector<double> resample(sorted.size());
+  std::vector<double> medians;
+  medians.reserve(num_resamples);
+  for(std::size_t i = 0; i < num_resamples; ++i) {
+    for(auto& x : resample) x = sorted[pick(rng)];
+    std::sort(resample.begin(), resample.end());
+    medians.push_back(median(resample));
+  }
+  std::sort(medians.begin(), medians.end());
+  return {percentile(medians, 0.025), percentile(medians, 0.975)};
+}
+
+} // namespace detail
+
 template <typename Benchmark>
 class TimeMetricsProcessor {
 public:
@@ -37,7 +123,10 @@ public:
     if(unavailableTimings.count(name) != 0) {
       throw std::invalid_argument{"Cannot add result for unavailable timing " + name};
     }
-    timingResults[name].push_back(time);
+    auto& results = timingResults[name];
+    results.push_back(time);
+    // Allows streaming consumers to record every sample as soon as it has been measured
+    args.result_consumer->consumeSample(name, results.size() - 1, time.count() / 1.0e9, "s");
   }
 
   /**
@@ -53,6 +142,34 @@ public:
     unavailableTimings.insert(name);
   }
 
+  /**
+   * Returns the relative half-width of the 95% confidence interval of the median of the given timing,
+   * i.e. (upper - lower) / (2 * median). Returns infinity if there are not yet enough samples
+   * to compute a meaningful interval.
+   */
+  double getRelativeMedianCI(const std::string& name) const {
+    if(timingResults.count(name) == 0)
+      return std::numeric_limits<double>::infinity();
+    const auto resultsSeconds = getSortedSeconds(name);
+    if(resultsSeconds.size() < 2)
+      return std::numeric_limits<double>::infinity();
+    const double median = detail::median(resultsSeconds);
+    if(median <= 0.0)
+      return std::numeric_limits<double>::infinity();
+    const auto [lower, upper] = detail::medianConfidenceInterval(resultsSeconds);
+    return (upper - lower) / (2.0 * median);
+  }
+
+  // Returns the median of the given timing in seconds, or nothing if there are no samples
+  std::optional<double> getMedian(const std::string& name) const {
+    if(timingResults.count(name) == 0)
+      return std::nullopt;
+    const auto resultsSeconds = getSortedSeconds(name);
+    if(resultsSeconds.empty())
+      return std::nullopt;
+    return detail::median(resultsSeconds);
+  }
+
   void emitResults(ResultConsumer& consumer) const {
     // Begin by outputting the throughput metric (if available), as this does not depend on a timing.
     if constexpr(detail::BenchmarkTraits<Benchmark>::hasGetThroughputMetric) {
@@ -62,6 +179,12 @@ public:
       consumer.consumeResult("throughput-metric", "N/A", "");
     }
 
+    std::size_t numRuns = 0;
+    for(const auto& [name, results] : timingResults) {
+      numRuns = std::max(numRuns, getSortedSeconds(name).size());
+    }
+    consumer.consumeResult("num-runs", std::to_string(numRuns));
+
     // We have to ensure that available and unavailable timings are always being emitted in the same order.
     // To this end, we copy all timing names into a sorted container and iterate over it afterwards.
     std::set<std::string> allTimings;
@@ -74,15 +197,7 @@ public:
 
     for(const auto& name : allTimings) {
       if(unavailableTimings.count(name) == 0) {
-        std::vector<double> resultsSeconds;
-        auto timesBegin = timingResults.at(name).begin();
-        // If verification is enabled and fails, only the warmup run is executed.
-        if (timingResults.size() > 1 && args.warmup_run) {
-          ++timesBegin;
-        }
-        std::transform(timesBegin, timingResults.at(name).end(), std::back_inserter(resultsSeconds),
-            [](auto r) { return r.count() / 1.0e9; });
-        std::sort(resultsSeconds.begin(), resultsSeconds.end());
+        const std::vector<double> resultsSeconds = getSortedSeconds(name);
 
         double mean = std::accumulate(resultsSeconds.begin(), resultsSeconds.end(), 0.0) /
                       static_cast<double>(resultsSeconds.size());
@@ -99,12 +214,26 @@ public:
           stddev = std::sqrt(stddev);
         }
 
-        const double median = resultsSeconds[resultsSeconds.size() / 2];
+        const double median = detail::median(resultsSeconds);
+        // -median-rel-ci and -median-ci-* use the same order-statistic interval as the --target-ci stopping rule
+        const auto [ci_lower, ci_upper] = detail::medianConfidenceInterval(resultsSeconds);
+        const auto [bootstrap_lower, bootstrap_upper] = detail::bootstrapMedianConfidenceInterval(resultsSeconds);
 
         consumer.consumeResult(name + "-mean", std::to_string(mean), "s");
         consumer.consumeResult(name + "-stddev", std::to_string(stddev), "s");
+        consumer.consumeResult(name + "-cv", mean > 0.0 ? std::to_string(stddev / mean) : "N/A");
         consumer.consumeResult(name + "-median", std::to_string(median), "s");
         consumer.consumeResult(name + "-min", std::to_string(resultsSeconds[0]), "s");
+        for(const auto& [suffix, p] : percentiles) {
+          consumer.consumeResult(name + suffix, std::to_string(detail::percentile(resultsSeconds, p)), "s");
+        }
+        consumer.consumeResult(name + "-mad", std::to_string(detail::medianAbsoluteDeviation(resultsSeconds)), "s");
+        consumer.consumeResult(name + "-outliers", std::to_string(detail::countOutliers(resultsSeconds)));
+        consumer.consumeResult(name + "-median-rel-ci", std::to_string(getRelativeMedianCI(name)));
+        consumer.consumeResult(name + "-median-ci-lower", std::to_string(ci_lower), "s");
+        consumer.consumeResult(name + "-median-ci-upper", std::to_string(ci_upper), "s");
+        consumer.consumeResult(name + "-median-bootstrap-ci-lower", std::to_string(bootstrap_lower), "s");
+        consumer.consumeResult(name + "-median-bootstrap-ci-upper", std::to_string(bootstrap_upper), "s");
 
         // Emit individual samples as well
         std::stringstream samples;
@@ -138,8 +267,19 @@ public:
         // FIXME: Come up with a cleaner solution.
         consumer.consumeResult(name + "-mean", "N/A");
         consumer.consumeResult(name + "-stddev", "N/A");
+        consumer.consumeResult(name + "-cv", "N/A");
         consumer.consumeResult(name + "-median", "N/A");
         consumer.consumeResult(name + "-min", "N/A");
+        for(const auto& [suffix, p] : percentiles) {
+          consumer.consumeResult(name + suffix, "N/A");
+        }
+        consumer.consumeResult(name + "-mad", "N/A");
+        consumer.consumeResult(name + "-outliers", "N/A");
+        consumer.consumeResult(name + "-median-rel-ci", "N/A");
+        consumer.consumeResult(name + "-median-ci-lower", "N/A");
+        consumer.consumeResult(name + "-median-ci-upper", "N/A");
+        consumer.consumeResult(name + "-median-bootstrap-ci-lower", "N/A");
+        consumer.consumeResult(name + "-median-bootstrap-ci-upper", "N/A");
         consumer.consumeResult(name + "-samples", "N/A");
         consumer.consumeResult(name + "-throughput", "N/A");
       }
@@ -147,6 +287,24 @@ public:
   }
 
 private:
+  // Percentiles emitted for every timing, as (column suffix, percentile)
+  static constexpr std::pair<const char*, double> percentiles[] = {
+      {"-p5", 0.05}, {"-p25", 0.25}, {"-p75", 0.75}, {"-p95", 0.95}, {"-p99", 0.99}};
+
+  // Returns the samples of the given timing in seconds and sorted ascendingly
+  std::vector<double> getSortedSeconds(const std::string& name) const {
+    std::vector<double> resultsSeconds;
+    auto timesBegin = timingResults.at(name).begin();
+    // If verification is enabled and fails, only the warmup run is executed.
+    if (timingResults.size() > 1 && args.warmup_run) {
+      ++timesBegin;
+    }
+    std::transform(timesBegin, timingResults.at(name).end(), std::back_inserter(resultsSeconds),
+        [](auto r) { return r.count() / 1.0e9; });
+    std::sort(resultsSeconds.begin(), resultsSeconds.end());
+    return resultsSeconds;
+  }
+
   const BenchmarkArgs args;
   std::unordered_map<std::string, std::vector<std::chrono::nanoseconds>> timingResults;
   std::unordered_set<std::string> unavailableTimings;
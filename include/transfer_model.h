@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "result_consumer.h"
+
+struct TransferModelFit {
+  // Startup latency in seconds
+  double latency = 0.0;
+  // Asymptotic bandwidth in bytes per second
+  double bandwidth = 0.0;
+  // Message size in bytes at which half of the asymptotic bandwidth is achieved
+  double n_half = 0.0;
+  std::size_t num_points = 0;
+};
+
+/**
+ * Fits the latency-bandwidth model t(n) = latency + n / bandwidth to the median transfer times of copy
+ * benchmarks over a range of message sizes. Benchmarks opt in by providing
+ *
+ *   static double getTransferBytes(const BenchmarkArgs& args);  // bytes transferred per run
+ *
+ * Every benchmark name and device forms one transfer path, and every problem size one point of its
+ * curve (see micro/transfer_sweep.cpp). After each point, the model of the path is refitted over all
+ * points measured so far, so the results of the last problem size describe the whole sweep.
+ *
+ * The fit minimizes the relative instead of the absolute error of the times, as message sizes span
+ * many orders of magnitude and the small messages would otherwise have no influence on the latency.
+ */
+class TransferModel {
+public:
+  static TransferModel& get() {
+    static TransferModel model;
+    return model;
+  }
+
+  // Records the time of a transfer of the given size, replacing an earlier one of the same size
+  void recordPoint(const std::string& device, const std::string& path, double bytes, double seconds) {
+    if(seconds > 0.0)
+      curves[{device, path}][bytes] = seconds;
+  }
+
+  std::optional<TransferModelFit> fit(const std::string& device, const std::string& path) const {
+    const auto it = curves.find({device, path});
+    if(it == curves.end() || it->second.size() < 2)
+      return std::nullopt;
+    const auto& points = it->second;
+
+    // Weighted least squares with weights 1 / t^2, using the weighted means for numerical stability
+    double sum_w = 0.0, mean_n = 0.0, mean_t = 0.0;
+    for(const auto& [n, t] : points) {
+      const double w = 1.0 / (t * t);
+      sum_w += w;
+      mean_n += w * n;
+      mean_t += w * t;
+    }
+    mean_n /= sum_w;
+    mean_t /= sum_w;
+    double cov = 0.0, var = 0.0;
+    for(const auto& [n, t] : points) {
+      const double w = 1.0 / (t * t);
+      cov += w * (n - mean_n) * (t - mean_t);
+      var += w * (n - mean_n) * (n - mean_n);
+    }
+    if(var <= 0.0)
+      return std::nullopt;
+    double seconds_per_byte = cov / var;
+    double latency = mean_t - seconds_per_byte * mean_n;
+    // A negative latency is not physical; fit the bandwidth alone through the origin instead
+    if(latency < 0.0) {
+      double sum_nt = 0.0, sum_nn = 0.0;
+      for(const auto& [n, t] : points) {
+        const double w = 1.0 / (t * t);
+        sum_nt += w * n * t;
+        sum_nn += w * n * n;
+      }
+      latency = 0.0;
+      seconds_per_byte = sum_nt / sum_nn;
+    }
+    if(seconds_per_byte <= 0.0)
+      return std::nullopt;
+
+    TransferModelFit result;
+    result.latency = latency;
+    result.bandwidth = 1.0 / seconds_per_byte;
+    result.n_half = latency * result.bandwidth;
+    result.num_points = points.size();
+    return result;
+  }
+
+  /**
+   * Emits transfer-latency [us], transfer-bandwidth [GiB/s], transfer-n-half [B] and transfer-fit-points
+   * of the path, or N/A while fewer than two points are known.
+   */
+  void emitResults(ResultConsumer& consumer, const std::string& device, const std::string& path) const {
+    const auto result = fit(device, path);
+    if(result.has_value()) {
+      consumer.consumeResult("transfer-latency", std::to_string(result->latency * 1.0e6), "us");
+      consumer.consumeResult("transfer-bandwidth", std::to_string(result->bandwidth / gib), "GiB/s");
+      consumer.consumeResult("transfer-n-half", std::to_string(result->n_half), "B");
+      consumer.consumeResult("transfer-fit-points", std::to_string(result->num_points));
+    } else {
+      consumer.consumeResult("transfer-latency", "N/A");
+      consumer.consumeResult("transfer-bandwidth", "N/A");
+      consumer.consumeResult("transfer-n-half", "N/A");
+      consumer.consumeResult("transfer-fit-points", "N/A");
+    }
+  }
+
+private:
+  static constexpr double gib = 1024.0 * 1024.0 * 1024.0;
+
+  // Median transfer time per message size, per device and path
+  std::map<std::pair<std::string, std::string>, std::map<double, double>> curves;
+};
@@ -7,9 +7,8 @@ struct ReadableTypename {};
 #define MAKE_READABLE_TYPENAME(T, str)                                                                                 \
   template <>                                                                                                          \
   struct ReadableTypename<T> {                                                                                         \
-    static const char* name;                                                                                           \
-  };                                                                                                                   \
-  const char* ReadableTypename<T>::name = str;
+    static constexpr const char* name = str;                                                                           \
+  };
 
 MAKE_READABLE_TYPENAME(char, "int8")
 MAKE_READABLE_TYPENAME(unsigned char, "uint8")
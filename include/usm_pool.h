@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <sycl/sycl.hpp>
+
+struct USMPoolStatistics {
+  // Calls of allocate(), served from the cache (hits) or by sycl::malloc (misses)
+  std::size_t allocations = 0;
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+  std::size_t deallocations = 0;
+  // Bytes currently kept in the free lists, and their peak since the last resetStatistics()
+  std::size_t cached_bytes = 0;
+  std::size_t peak_cached_bytes = 0;
+  // Bytes returned to the SYCL runtime by trim()
+  std::size_t trimmed_bytes = 0;
+
+  USMPoolStatistics& operator+=(const USMPoolStatistics& other) {
+    allocations += other.allocations;
+    hits += other.hits;
+    misses += other.misses;
+    deallocations += other.deallocations;
+    cached_bytes += other.cached_bytes;
+    peak_cached_bytes += other.peak_cached_bytes;
+    trimmed_bytes += other.trimmed_bytes;
+    return *this;
+  }
+};
+
+/**
+ * Caching allocator for USM memory of one kind (device, host or shared) in one context and device,
+ * as production codes use it to avoid the cost of sycl::malloc and sycl::free (see
+ * sycl2020/USM/usm_allocation_latency.cpp).
+ *
+ * Requests are rounded up to size classes with four classes per power of two, so that at most 25% of
+ * a block is wasted. Freed blocks are kept in a free list per size class and reused by later requests
+ * of the same class. The free lists are protected by a mutex, so pools can be used from several
+ * threads. Once more than the configured number of bytes is cached, the least recently freed blocks
+ * are released to the SYCL runtime; trim() does so explicitly.
+ *
+ * With --usm-pool, USMBuffer allocates through the pools. BenchmarkApp trims all pools after every
+ * benchmark, so that benchmarks do not reuse each other's memory.
+ */
+class USMPool {
+public:
+  static constexpr std::size_t min_block_size = 256;
+  static constexpr std::size_t default_max_cached_bytes = std::size_t{1} << 30;
+
+  // Returns the pool for the context and device of the queue and the given kind of USM
+  static USMPool& get(const sycl::queue& q, sycl::usm::alloc kind) {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    const auto context = q.get_context();
+    const auto device = q.get_device();
+    for(const auto& pool : r.pools) {
+      if(pool->kind == kind && pool->context == context && pool->device == device)
+        return *pool;
+    }
+    r.pools.push_back(std::unique_ptr<USMPool>{new USMPool{context, device, kind}});
+    return *r.pools.back();
+  }
+
+  // Whether USMBuffer allocates through the pools (--usm-pool)
+  static bool isEnabled() { return registry().enabled; }
+
+  static void setEnabled(bool enabled) { registry().enabled = enabled; }
+
+  // Upper bound of the bytes cached per pool (--usm-pool-limit)
+  static void setMaxCachedBytes(std::size_t bytes) { registry().max_cached_bytes = bytes; }
+
+  // Releases all cached blocks of all pools
+  static void trimAll() {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    for(const auto& pool : r.pools) pool->trim();
+  }
+
+  static USMPoolStatistics getTotalStatistics() {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    USMPoolStatistics total;
+    for(const auto& pool : r.pools) total += pool->getStatistics();
+    return total;
+  }
+
+  static void resetTotalStatistics() {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    for(const auto& pool : r.pools) pool->resetStatistics();
+  }
+
+  // Rounds up to the next size class: a multiple of a quarter of the largest power of two below bytes
+  static std::size_t getSizeClass(std::size_t bytes) {
+    if(bytes <= min_block_size)
+      return min_block_size;
+    std::size_t power = min_block_size;
+    while(power * 2 < bytes) power *= 2;
+    const std::size_t step = power / 4;
+    return (bytes + step - 1) / step * step;
+  }
+
+  // Returns a block of at least the given size, or nullptr if the allocation failed
+  void* allocate(std::size_t bytes) {
+    const std::size_t size_class = getSizeClass(bytes);
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      ++statistics.allocations;
+      auto& list = free_lists[size_class];
+      if(!list.empty()) {
+        // Reuse the most recently freed block, which is the most likely one to still be in caches and TLBs
+        void* ptr = list.back()->ptr;
+        cached_blocks.erase(list.back());
+        list.pop_back();
+        statistics.cached_bytes -= size_class;
+        ++statistics.hits;
+        return ptr;
+      }
+      ++statistics.misses;
+    }
+
+    void* ptr = sycl::malloc(size_class, device, context, kind);
+    if(ptr == nullptr) {
+      // Cached blocks of other size classes may be what keeps the allocation from succeeding
+      trim();
+      ptr = sycl::malloc(size_class, device, context, kind);
+    }
+    return ptr;
+  }
+
+  // Returns a block obtained from allocate() with the same size to the pool
+  void deallocate(void* ptr, std::size_t bytes) {
+    if(ptr == nullptr)
+      return;
+    const std::size_t size_class = getSizeClass(bytes);
+    std::lock_guard<std::mutex> lock{mutex};
+    ++statistics.deallocations;
+    cached_blocks.push_back(Block{ptr, size_class});
+    free_lists[size_class].push_back(std::prev(cached_blocks.end()));
+    statistics.cached_bytes += size_class;
+    statistics.peak_cached_bytes = std::max(statistics.peak_cached_bytes, statistics.cached_bytes);
+    trimLocked(registry().max_cached_bytes);
+  }
+
+  // Releases cached blocks until at most max_cached_bytes remain cached
+  void trim(std::size_t max_cached_bytes = 0) {
+    std::lock_guard<std::mutex> lock{mutex};
+    trimLocked(max_cached_bytes);
+  }
+
+  USMPoolStatistics getStatistics() const {
+    std::lock_guard<std::mutex> lock{mutex};
+    return statistics;
+  }
+
+  void resetStatistics() {
+    std::lock_guard<std::mutex> lock{mutex};
+    const std::size_t cached_bytes = statistics.cached_bytes;
+    statistics = USMPoolStatistics{};
+    statistics.cached_bytes = cached_bytes;
+    statistics.peak_cached_bytes = cached_bytes;
+  }
+
+  USMPool(const USMPool&) = delete;
+  USMPool& operator=(const USMPool&) = delete;
+
+private:
+  struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<USMPool>> pools;
+    bool enabled = false;
+    std::size_t max_cached_bytes = default_max_cached_bytes;
+  };
+
+  // Cached blocks are never freed during static destruction, when the SYCL runtime may already be gone
+  static Registry& registry() {
+    static Registry* r = new Registry;
+    return *r;
+  }
+
+  USMPool(sycl::context context, sycl::device device, sycl::usm::alloc kind)
+      : context{std::move(context)}, device{std::move(device)}, kind{kind} {}
+
+  // Releases the least recently freed blocks first. Within a size class, blocks are ordered by the time
+  // they were freed as well, so the oldest block overall is the first one of its free list.
+  void trimLocked(std::size_t max_cached_bytes) {
+    while(statistics.cached_bytes > max_cached_bytes && !cached_blocks.empty()) {
+      const Block block = cached_blocks.front();
+      auto& list = free_lists[block.size_class];
+      list.erase(list.begin());
+      cached_blocks.pop_front();
+      sycl::free(block.ptr, context);
+      statistics.cached_bytes -= block.size_class;
+      statistics.trimmed_bytes += block.size_class;
+    }
+  }
+
+  const sycl::context context;
+  const sycl::device device;
+  const sycl::usm::alloc kind;
+
+  struct Block {
+    void* ptr;
+    std::size_t size_class;
+  };
+
+  mutable std::mutex mutex;
+  // All cached blocks, from least to most recently freed
+  std::list<Block> cached_blocks;
+  // Cached blocks per size class, in the same order
+  std::map<std::size_t, std::vector<std::list<Block>::iterator>> free_lists;
+  USMPoolStatistics statistics;
+};
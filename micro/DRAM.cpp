@@ -2,7 +2,7 @@
 
 namespace s = sycl;
 
-template <typename DataT, int Dims>
+template <typename DataT, int Dims, MemoryBackend Backend>
 class MicroBenchDRAMKernel;
 
 template <typename DataT, int Dims>
@@ -21,26 +21,42 @@ s::range<Dims> getBufferSize(size_t problemSize) {
   }
 }
 
+// Value of the input element with the given linear index, usable as a generator of DeviceData::initialize.
+// Depends on the index, so that verification also detects misplaced writes.
+template <typename DataT>
+struct DRAMInput {
+  DataT operator()(std::size_t i) const { return static_cast<DataT>(i % 251); }
+};
+
 /**
  * Microbenchmark measuring DRAM bandwidth.
+ *
+ * With --no-host-mirror, the input is generated on the device and only samples of the output are verified.
  */
-template <typename DataT, int Dims>
+template <typename DataT, int Dims, MemoryBackend Backend = MemoryBackend::buffer>
 class MicroBenchDRAM {
 protected:
   BenchmarkArgs args;
   const s::range<Dims> buffer_size;
   // Since we cannot use explicit memory operations to initialize the input buffer,
-  // we have to keep this around, unfortunately.
+  // we have to keep this around, unfortunately (unless it is generated on the device).
   std::vector<DataT> input;
-  PrefetchedBuffer<DataT, Dims> input_buf;
-  PrefetchedBuffer<DataT, Dims> output_buf;
+  DeviceData<DataT, Dims, Backend> input_buf;
+  DeviceData<DataT, Dims, Backend> output_buf;
 
 public:
-  MicroBenchDRAM(const BenchmarkArgs& args)
-      : args(args), buffer_size(getBufferSize<DataT, Dims>(args.problem_size)), input(buffer_size.size(), 33.f) {}
+  static constexpr MemoryBackend memory_backend = Backend;
+
+  MicroBenchDRAM(const BenchmarkArgs& args) : args(args), buffer_size(getBufferSize<DataT, Dims>(args.problem_size)) {}
 
   void setup() {
-    input_buf.initialize(args.device_queue, input.data(), buffer_size);
+    if(DeviceInit::isEnabled()) {
+      input_buf.initialize(args.device_queue, buffer_size, DRAMInput<DataT>{});
+    } else {
+      input.resize(buffer_size.size());
+      generateInput(input.data(), input.size(), DRAMInput<DataT>{});
+      input_buf.initialize(args.device_queue, input.data(), buffer_size);
+    }
     output_buf.initialize(args.device_queue, buffer_size);
   }
 
@@ -51,33 +67,51 @@ public:
     return {copiedGiB * 2.0, "GiB"};
   }
 
+  static double getBytesMoved(const BenchmarkArgs& args) {
+    return 2.0 * getBufferSize<DataT, Dims>(args.problem_size).size() * sizeof(DataT);
+  }
+
+  static RooflineCeiling getRooflineCeiling() { return RooflineCeiling::memory_bandwidth; }
+
   void run(std::vector<s::event>& events) {
     events.push_back(args.device_queue.submit([&](sycl::handler& cgh) {
       auto in = input_buf.template get_access<s::access::mode::read>(cgh);
       auto out = output_buf.template get_access<s::access::mode::discard_write>(cgh);
       // We spawn one work item for each buffer element to be copied.
       const s::range<Dims> global_size{buffer_size};
-      cgh.parallel_for<MicroBenchDRAMKernel<DataT, Dims>>(global_size, [=](s::id<Dims> gid) { out[gid] = in[gid]; });
+      cgh.parallel_for<MicroBenchDRAMKernel<DataT, Dims, Backend>>(
+          global_size, [=](s::id<Dims> gid) { out[gid] = in[gid]; });
     }));
   }
 
   bool verify(VerificationSetting& ver) {
+    if(DeviceInit::isEnabled()) {
+      const auto indices = DeviceInit::getSampleIndices(buffer_size.size());
+      const auto samples = output_buf.gather_samples(args.device_queue, indices);
+      for(std::size_t i = 0; i < indices.size(); ++i) {
+        if(samples[i] != DRAMInput<DataT>{}(indices[i]))
+          return false;
+      }
+      return true;
+    }
+
     auto result = output_buf.get_host_access();
+    const DRAMInput<DataT> expected;
     for(size_t i = 0; i < buffer_size[0]; ++i) {
       for(size_t j = 0; j < (Dims < 2 ? 1 : buffer_size[1]); ++j) {
         for(size_t k = 0; k < (Dims < 3 ? 1 : buffer_size[2]); ++k) {
           if constexpr(Dims == 1) {
-            if(result[i] != 33.f) {
+            if(result[i] != expected(i)) {
               return false;
             }
           }
           if constexpr(Dims == 2) {
-            if(result[{i, j}] != 33.f) {
+            if(result[{i, j}] != expected(i * buffer_size[1] + j)) {
               return false;
             }
           }
           if constexpr(Dims == 3) {
-            if(result[{i, j, k}] != 33.f) {
+            if(result[{i, j, k}] != expected((i * buffer_size[1] + j) * buffer_size[2] + k)) {
               return false;
             }
           }
@@ -87,6 +121,8 @@ public:
     return true;
   }
 
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) {
     std::stringstream name;
     name << "MicroBench_DRAM_";
@@ -96,16 +132,111 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+template <typename DataT>
+class MicroBenchDRAMStreamingKernel;
 
-  app.run<MicroBenchDRAM<float, 1>>();
-  app.run<MicroBenchDRAM<float, 2>>();
-  app.run<MicroBenchDRAM<float, 3>>();
-  if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
-    app.run<MicroBenchDRAM<double, 1>>();
-    app.run<MicroBenchDRAM<double, 2>>();
-    app.run<MicroBenchDRAM<double, 3>>();
+/**
+ * Out-of-core variant of MicroBenchDRAM (--streaming): copies the same number of elements as the 1D
+ * benchmark from one pinned host array to another, tile by tile through the device (see StreamingPipeline).
+ */
+template <typename DataT>
+class MicroBenchDRAMStreaming {
+protected:
+  BenchmarkArgs args;
+  const std::size_t num_elements;
+  USMBuffer<DataT, 1, s::usm::alloc::host> input;
+  USMBuffer<DataT, 1, s::usm::alloc::host> output;
+  StreamingPipeline pipeline;
+  // Every slot holds an input and an output tile
+  DataT* device_tiles = nullptr;
+
+  DataT* getTile(const StreamingTile& tile, std::size_t array) const {
+    return device_tiles + (2 * tile.slot + array) * pipeline.getTileElements();
   }
-  return 0;
+
+  static DataT getInput(std::size_t i) { return static_cast<DataT>(i % 1024); }
+
+public:
+  MicroBenchDRAMStreaming(const BenchmarkArgs& args)
+      : args(args), num_elements(getBufferSize<DataT, 1>(args.problem_size).size()),
+        pipeline{num_elements, 2 * sizeof(DataT)} {}
+
+  ~MicroBenchDRAMStreaming() {
+    if(device_tiles != nullptr)
+      s::free(device_tiles, args.device_queue);
+  }
+
+  void setup() {
+    input.initialize(args.device_queue, num_elements);
+    output.initialize(args.device_queue, num_elements);
+    generateInput(input.get(), num_elements, getInput);
+    device_tiles = s::malloc_device<DataT>(2 * pipeline.getTileElements() * pipeline.getDepth(), args.device_queue);
+
+    pipeline.setStages(
+        [this](const StreamingTile& tile, const s::event& dependency) {
+          return args.device_queue.memcpy(
+              getTile(tile, 0), input.get() + tile.offset, tile.count * sizeof(DataT), dependency);
+        },
+        [this](const StreamingTile& tile, const s::event& dependency) {
+          return args.device_queue.submit([&](s::handler& cgh) {
+            cgh.depends_on(dependency);
+            const DataT* in = getTile(tile, 0);
+            DataT* out = getTile(tile, 1);
+            cgh.parallel_for<MicroBenchDRAMStreamingKernel<DataT>>(
+                s::range<1>{tile.count}, [=](s::id<1> gid) { out[gid] = in[gid]; });
+          });
+        },
+        [this](const StreamingTile& tile, const s::event& dependency) {
+          return args.device_queue.memcpy(
+              output.get() + tile.offset, getTile(tile, 1), tile.count * sizeof(DataT), dependency);
+        });
+    pipeline.calibrate();
+  }
+
+  void run() { pipeline.run(); }
+
+  bool verify(VerificationSetting& ver) {
+    for(std::size_t i = 0; i < num_elements; ++i) {
+      if(output.get()[i] != getInput(i))
+        return false;
+    }
+    return true;
+  }
+
+  // End-to-end throughput in bytes copied between host and device
+  static ThroughputMetric getThroughputMetric(const BenchmarkArgs& args) {
+    const double copiedGiB =
+        getBufferSize<DataT, 1>(args.problem_size).size() * sizeof(DataT) / 1024.0 / 1024.0 / 1024.0;
+    return {copiedGiB * 2.0, "GiB"};
+  }
+
+  static constexpr bool idempotent = true;
+
+  static std::string getBenchmarkName(BenchmarkArgs& args) {
+    std::stringstream name;
+    name << "MicroBench_DRAM_Streaming_";
+    name << ReadableTypename<DataT>::name;
+    return name.str();
+  }
+};
+
+SYCL_BENCH_SUITE(DRAM, "micro", app) {
+  if(app.shouldRunStreaming()) {
+    app.run<MicroBenchDRAMStreaming<float>>();
+    if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
+      app.run<MicroBenchDRAMStreaming<double>>();
+    }
+    return;
+  }
+
+  app.forEachMemoryBackend([&](auto backend) {
+    app.run<MicroBenchDRAM<float, 1, backend>>();
+    app.run<MicroBenchDRAM<float, 2, backend>>();
+    app.run<MicroBenchDRAM<float, 3, backend>>();
+    if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
+      app.run<MicroBenchDRAM<double, 1, backend>>();
+      app.run<MicroBenchDRAM<double, 2, backend>>();
+      app.run<MicroBenchDRAM<double, 3, backend>>();
+    }
+  });
 }
@@ -46,6 +46,16 @@ public:
     return {};
   }
 
+  // For int, these are integer operations
+  static double getFlops(const BenchmarkArgs& args) {
+    return static_cast<double>(args.problem_size) * Iterations * 2 * 2;
+  }
+
+  // The compute ceiling of the roofline is the single precision peak
+  static RooflineCeiling getRooflineCeiling() {
+    return std::is_same_v<DataT, float> ? RooflineCeiling::compute : RooflineCeiling::none;
+  }
+
   void run(std::vector<sycl::event>& events) {
     events.push_back(args.device_queue.submit([&](sycl::handler& cgh) {
       auto in = input_buf.template get_access<s::access::mode::read>(cgh);
@@ -77,6 +87,8 @@ public:
     return true;
   }
 
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) {
     std::stringstream name;
     name << "MicroBench_Arith_";
@@ -86,13 +98,10 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-
+SYCL_BENCH_SUITE(arith, "micro", app) {
   app.run<MicroBenchArithmetic<int>>();
   app.run<MicroBenchArithmetic<float>>();
   if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
     app.run<MicroBenchArithmetic<double>>();
   }
-  return 0;
 }
@@ -38,7 +38,8 @@ constexpr s::id<Dims> getStridedCopyOffset() {
   }
 }
 
-enum class CopyDirection { HOST_TO_DEVICE, DEVICE_TO_HOST };
+// ROUND_TRIP is only supported by chunked transfers
+enum class CopyDirection { HOST_TO_DEVICE, DEVICE_TO_HOST, ROUND_TRIP };
 
 template <int Dims, bool Strided>
 class D2HInitKernel;
@@ -226,6 +227,8 @@ public:
     return false;
   }
 
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) {
     std::stringstream name;
     name << "MicroBench_HostDeviceBandwidth_";
@@ -236,9 +239,216 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+enum class ChunkedCopyMethod { USM_MEMCPY, BUFFER_ACCESSOR };
+
+template <ChunkedCopyMethod Method>
+class ChunkedInitKernel;
+
+// Default sweeps of --chunk-sizes (in KiB) and --pipeline-depths
+static constexpr const char* default_chunk_sizes = "64:16384:x4";
+static constexpr const char* default_pipeline_depths = "1:4";
+
+/**
+ * Microbenchmark measuring the throughput of large contiguous transfers that are split into chunks and
+ * staged through a ring of pinned host buffers (sycl::malloc_host), as ingestion paths move data that
+ * arrives in pageable memory.
+ *
+ * Up to pipeline_depth chunks are in flight: while the device copies a chunk out of (or into) one
+ * staging slot, the host fills (or drains) the next ones. A slot is only reused once the copy of the
+ * chunk pipeline_depth chunks earlier has completed, so a depth of 1 serializes host staging and device
+ * copies. Round trips copy each chunk to the device and back into a second staging ring.
+ *
+ * Chunks are copied with queue::memcpy from and to a device allocation, or with explicit copies from and
+ * to ranged accessors of a SYCL buffer.
+ */
+template <CopyDirection Direction, ChunkedCopyMethod Method>
+class MicroBenchHostDeviceChunkedTransfer {
+protected:
+  BenchmarkArgs args;
+  const std::size_t num_elements;
+  const std::size_t chunk_elements;
+  const std::size_t pipeline_depth;
+  // Pageable source and destination of the transfer
+  std::vector<DataT> host_src;
+  std::vector<DataT> host_dst;
+  // pipeline_depth slots of chunk_elements each
+  DataT* staging_up = nullptr;
+  DataT* staging_down = nullptr;
+  DataT* device_data = nullptr;
+  std::unique_ptr<s::buffer<DataT, 1>> buffer;
+
+  static constexpr bool uploads = Direction != CopyDirection::DEVICE_TO_HOST;
+  static constexpr bool downloads = Direction != CopyDirection::HOST_TO_DEVICE;
+
+public:
+  MicroBenchHostDeviceChunkedTransfer(const BenchmarkArgs& args, std::size_t chunk_bytes, std::size_t pipeline_depth)
+      : args(args), num_elements(getBufferSize<1, false>(args.problem_size).size()),
+        chunk_elements(std::clamp<std::size_t>(chunk_bytes / sizeof(DataT), 1, num_elements)),
+        pipeline_depth(pipeline_depth) {}
+
+  ~MicroBenchHostDeviceChunkedTransfer() {
+    if(staging_up != nullptr)
+      s::free(staging_up, args.device_queue);
+    if(staging_down != nullptr)
+      s::free(staging_down, args.device_queue);
+    if(device_data != nullptr)
+      s::free(device_data, args.device_queue);
+  }
+
+  void setup() {
+    const std::size_t ring_elements = chunk_elements * pipeline_depth;
+    if constexpr(uploads) {
+      host_src.resize(num_elements);
+      generateInput(host_src.data(), num_elements, [](std::size_t i) { return static_cast<DataT>(i); });
+      staging_up = s::malloc_host<DataT>(ring_elements, args.device_queue);
+    }
+    if constexpr(downloads) {
+      host_dst.resize(num_elements);
+      staging_down = s::malloc_host<DataT>(ring_elements, args.device_queue);
+    }
+
+    if constexpr(Method == ChunkedCopyMethod::USM_MEMCPY) {
+      device_data = s::malloc_device<DataT>(num_elements, args.device_queue);
+      if constexpr(Direction == CopyDirection::DEVICE_TO_HOST) {
+        DataT* ptr = device_data;
+        args.device_queue.parallel_for<ChunkedInitKernel<Method>>(
+            s::range<1>{num_elements}, [=](s::id<1> i) { ptr[i] = static_cast<DataT>(i[0]); });
+      }
+    } else {
+      buffer = std::make_unique<s::buffer<DataT, 1>>(s::range<1>{num_elements});
+      if constexpr(Direction == CopyDirection::DEVICE_TO_HOST) {
+        args.device_queue.submit([&](s::handler& cgh) {
+          auto acc = buffer->template get_access<s::access::mode::discard_write>(cgh);
+          cgh.parallel_for<ChunkedInitKernel<Method>>(
+              s::range<1>{num_elements}, [=](s::id<1> i) { acc[i] = static_cast<DataT>(i[0]); });
+        });
+      }
+    }
+  }
+
+  static ThroughputMetric getThroughputMetric(const BenchmarkArgs& args) {
+    const double copiedGiB = getBufferSize<1, false>(args.problem_size).size() * sizeof(DataT) *
+                             (Direction == CopyDirection::ROUND_TRIP ? 2 : 1) / 1024.0 / 1024.0 / 1024.0;
+    return {copiedGiB, "GiB"};
+  }
+
+  void run() {
+    const std::size_t num_chunks = (num_elements + chunk_elements - 1) / chunk_elements;
+    std::vector<s::event> slot_events(pipeline_depth);
+
+    // Chunk c is issued in iteration c and retired in iteration c + pipeline_depth, right before the
+    // next chunk using its slot is issued
+    for(std::size_t c = 0; c < num_chunks + pipeline_depth; ++c) {
+      const std::size_t slot = c % pipeline_depth;
+      if(c >= pipeline_depth) {
+        slot_events[slot].wait();
+        if constexpr(downloads) {
+          const std::size_t offset = (c - pipeline_depth) * chunk_elements;
+          const std::size_t count = std::min(chunk_elements, num_elements - offset);
+          std::copy_n(staging_down + slot * chunk_elements, count, host_dst.data() + offset);
+        }
+      }
+      if(c < num_chunks) {
+        const std::size_t offset = c * chunk_elements;
+        const std::size_t count = std::min(chunk_elements, num_elements - offset);
+        if constexpr(uploads)
+          std::copy_n(host_src.data() + offset, count, staging_up + slot * chunk_elements);
+        slot_events[slot] = submitChunk(slot, offset, count);
+      }
+    }
+  }
+
+  bool verify(VerificationSetting&) {
+    if constexpr(Direction == CopyDirection::HOST_TO_DEVICE) {
+      host_dst.resize(num_elements);
+      if constexpr(Method == ChunkedCopyMethod::USM_MEMCPY) {
+        args.device_queue.memcpy(host_dst.data(), device_data, num_elements * sizeof(DataT)).wait();
+      } else {
+        auto acc = buffer->get_host_access();
+        std::copy_n(acc.get_pointer(), num_elements, host_dst.data());
+      }
+    }
+    for(std::size_t i = 0; i < num_elements; ++i) {
+      if(host_dst[i] != static_cast<DataT>(i))
+        return false;
+    }
+    return true;
+  }
+
+  static constexpr bool idempotent = true;
+
+  std::string getBenchmarkName(BenchmarkArgs&) const {
+    std::stringstream name;
+    name << "MicroBench_HostDeviceBandwidth_Chunked_";
+    name << (Direction == CopyDirection::HOST_TO_DEVICE   ? "H2D_"
+             : Direction == CopyDirection::DEVICE_TO_HOST ? "D2H_"
+                                                          : "RoundTrip_");
+    name << (Method == ChunkedCopyMethod::USM_MEMCPY ? "Memcpy_" : "Accessor_");
+    name << (chunk_elements * sizeof(DataT) / 1024) << "KiB_depth_" << pipeline_depth;
+    return name.str();
+  }
+
+private:
+  // Copies chunk [offset, offset + count) between the staging slot and the device
+  s::event submitChunk(std::size_t slot, std::size_t offset, std::size_t count) {
+    // Only the staging rings of the transfer direction(s) are allocated
+    DataT* up = uploads ? staging_up + slot * chunk_elements : nullptr;
+    DataT* down = downloads ? staging_down + slot * chunk_elements : nullptr;
+    s::event event;
+    if constexpr(Method == ChunkedCopyMethod::USM_MEMCPY) {
+      const std::size_t bytes = count * sizeof(DataT);
+      if constexpr(uploads)
+        event = args.device_queue.memcpy(device_data + offset, up, bytes);
+      if constexpr(Direction == CopyDirection::ROUND_TRIP)
+        event = args.device_queue.memcpy(down, device_data + offset, bytes, event);
+      if constexpr(Direction == CopyDirection::DEVICE_TO_HOST)
+        event = args.device_queue.memcpy(down, device_data + offset, bytes);
+    } else {
+      // The runtime orders the download of a round trip after the upload of the same range
+      if constexpr(uploads) {
+        event = args.device_queue.submit([&](s::handler& cgh) {
+          auto acc =
+              buffer->template get_access<s::access::mode::discard_write>(cgh, s::range<1>{count}, s::id<1>{offset});
+          cgh.copy(static_cast<const DataT*>(up), acc);
+        });
+      }
+      if constexpr(downloads) {
+        event = args.device_queue.submit([&](s::handler& cgh) {
+          auto acc = buffer->template get_access<s::access::mode::read>(cgh, s::range<1>{count}, s::id<1>{offset});
+          cgh.copy(acc, down);
+        });
+      }
+    }
+    return event;
+  }
+};
+
+template <CopyDirection Direction, ChunkedCopyMethod Method>
+void runChunkedTransfers(BenchmarkApp& app) {
+  const auto& cli = app.getArgs().cli;
+  const auto chunk_sizes = detail::parseSweep(cli.getOrDefault<std::string>("--chunk-sizes", default_chunk_sizes));
+  const auto depths = detail::parseSweep(cli.getOrDefault<std::string>("--pipeline-depths", default_pipeline_depths));
+  if(std::find(chunk_sizes.begin(), chunk_sizes.end(), 0) != chunk_sizes.end())
+    throw std::invalid_argument{"--chunk-sizes must not contain a chunk size of 0"};
+  if(std::find(depths.begin(), depths.end(), 0) != depths.end())
+    throw std::invalid_argument{"--pipeline-depths must not contain a pipeline depth of 0"};
+  const std::size_t transfer_bytes = getBufferSize<1, false>(app.getArgs().problem_size).size() * sizeof(DataT);
+  // Chunks are clamped to the transfer, so all chunk sizes exceeding it would yield the same benchmark
+  bool ran_whole_transfer = false;
+  for(const auto chunk_kib : chunk_sizes) {
+    const std::size_t chunk_bytes = chunk_kib * 1024;
+    if(chunk_bytes >= transfer_bytes) {
+      if(ran_whole_transfer)
+        continue;
+      ran_whole_transfer = true;
+    }
+    for(const auto depth : depths) {
+      app.run<MicroBenchHostDeviceChunkedTransfer<Direction, Method>>(chunk_bytes, depth);
+    }
+  }
+}
 
+SYCL_BENCH_SUITE(host_device_bandwidth, "micro", app) {
   app.run<MicroBenchHostDeviceBandwidth<1, CopyDirection::HOST_TO_DEVICE, false>>();
   app.run<MicroBenchHostDeviceBandwidth<2, CopyDirection::HOST_TO_DEVICE, false>>();
   app.run<MicroBenchHostDeviceBandwidth<3, CopyDirection::HOST_TO_DEVICE, false>>();
@@ -255,5 +465,11 @@ int main(int argc, char** argv) {
   app.run<MicroBenchHostDeviceBandwidth<2, CopyDirection::DEVICE_TO_HOST, true>>();
   app.run<MicroBenchHostDeviceBandwidth<3, CopyDirection::DEVICE_TO_HOST, true>>();
 
-  return 0;
+  runChunkedTransfers<CopyDirection::HOST_TO_DEVICE, ChunkedCopyMethod::USM_MEMCPY>(app);
+  runChunkedTransfers<CopyDirection::DEVICE_TO_HOST, ChunkedCopyMethod::USM_MEMCPY>(app);
+  runChunkedTransfers<CopyDirection::ROUND_TRIP, ChunkedCopyMethod::USM_MEMCPY>(app);
+
+  runChunkedTransfers<CopyDirection::HOST_TO_DEVICE, ChunkedCopyMethod::BUFFER_ACCESSOR>(app);
+  runChunkedTransfers<CopyDirection::DEVICE_TO_HOST, ChunkedCopyMethod::BUFFER_ACCESSOR>(app);
+  runChunkedTransfers<CopyDirection::ROUND_TRIP, ChunkedCopyMethod::BUFFER_ACCESSOR>(app);
 }
\ No newline at end of file
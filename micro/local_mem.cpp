@@ -22,6 +22,9 @@ public:
     assert(args.problem_size % args.local_size == 0 && "Invalid problem_size/local_size combination.");
   }
 
+  // Local memory required per work group, used to bound the candidates of --autotune-local
+  static std::size_t getLocalMemoryUsage(const BenchmarkArgs& args) { return args.local_size * sizeof(DATA_TYPE); }
+
   void setup() {
     // buffers initialized to a default value
     input.resize(args.problem_size, 42);
@@ -64,6 +67,8 @@ public:
     })); // submit
   }
 
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) {
     std::stringstream name;
     name << "MicroBench_LocalMem_";
@@ -88,11 +93,9 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
+SYCL_BENCH_SUITE(local_mem, "micro", app) {
   constexpr int compute_iters = 1024 * 4;
 
-  BenchmarkApp app(argc, argv);
-
   // int
   app.run<MicroBenchLocalMemory<int, compute_iters>>();
 
@@ -103,5 +106,4 @@ int main(int argc, char** argv) {
   if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
     app.run<MicroBenchLocalMemory<double, compute_iters>>();
   }
-  return 0;
 }
@@ -45,6 +45,8 @@ public:
     })); // submit
   }
 
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) {
     std::stringstream name;
     name << "MicroBench_L2_";
@@ -54,9 +56,7 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-
+SYCL_BENCH_SUITE(pattern_L2, "micro", app) {
   // int
   app.run<MicroBenchL2<int, 1>>();
   app.run<MicroBenchL2<int, 2>>();
@@ -80,5 +80,4 @@ int main(int argc, char** argv) {
     app.run<MicroBenchL2<double, 8>>();
     app.run<MicroBenchL2<double, 16>>();
   }
-  return 0;
 }
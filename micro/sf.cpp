@@ -72,6 +72,8 @@ public:
     return true;
   }
 
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) {
     std::stringstream name;
     name << "MicroBench_sf_";
@@ -81,12 +83,9 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-
+SYCL_BENCH_SUITE(sf, "micro", app) {
   app.run<MicroBenchSpecialFunc<float>>();
   if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
     app.run<MicroBenchSpecialFunc<double>>();
   }
-  return 0;
 }
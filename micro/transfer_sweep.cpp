@@ -0,0 +1,155 @@
+#include "common.h"
+
+namespace s = sycl;
+
+// HOST_READ: a kernel reads host memory directly and writes it to device memory (zero-copy access)
+enum class TransferPath { HOST_TO_DEVICE, DEVICE_TO_HOST, DEVICE_TO_DEVICE, HOST_READ };
+
+// Device-to-device transfers do not involve host memory
+enum class HostMemory { NONE, PAGEABLE, PINNED };
+
+template <HostMemory Memory>
+class TransferSweepHostReadKernel;
+
+/**
+ * Microbenchmark measuring the time of a single copy of problem_size bytes along one transfer path, so
+ * that sweeping --size from a few bytes to gigabytes yields the full transfer curve of the path.
+ *
+ * Host-to-device and device-to-host copies use queue::memcpy from and to pageable (std::vector) or
+ * pinned (sycl::malloc_host) memory. Device-to-device copies use queue::memcpy between two device
+ * allocations. Host reads copy host memory to a device allocation with a kernel accessing the host
+ * memory directly, which requires system allocations (usm_system_allocations) for pageable memory.
+ *
+ * Every benchmark provides getTransferBytes(), so the latency-bandwidth model of its path is refitted
+ * after every size and reported as transfer-latency, transfer-bandwidth and transfer-n-half (see
+ * transfer_model.h).
+ */
+template <TransferPath Path, HostMemory Memory>
+class MicroBenchTransferSweep {
+protected:
+  BenchmarkArgs args;
+  const std::size_t bytes;
+  std::vector<unsigned char> pageable_data;
+  unsigned char* pinned_data = nullptr;
+  // Either pageable_data or pinned_data
+  unsigned char* host_data = nullptr;
+  unsigned char* device_src = nullptr;
+  unsigned char* device_dst = nullptr;
+
+  static constexpr bool reads_device = Path == TransferPath::DEVICE_TO_HOST || Path == TransferPath::DEVICE_TO_DEVICE;
+  static constexpr bool writes_device = Path != TransferPath::DEVICE_TO_HOST;
+
+  static unsigned char getPattern(std::size_t i) { return static_cast<unsigned char>(i ^ (i >> 8) ^ (i >> 16)); }
+
+public:
+  MicroBenchTransferSweep(const BenchmarkArgs& args) : args(args), bytes(args.problem_size) {}
+
+  ~MicroBenchTransferSweep() {
+    for(auto* ptr : {pinned_data, device_src, device_dst}) {
+      if(ptr != nullptr)
+        s::free(ptr, args.device_queue);
+    }
+  }
+
+  void setup() {
+    if constexpr(Memory == HostMemory::PAGEABLE) {
+      pageable_data.resize(bytes);
+      host_data = pageable_data.data();
+    } else if constexpr(Memory == HostMemory::PINNED) {
+      pinned_data = s::malloc_host<unsigned char>(bytes, args.device_queue);
+      host_data = pinned_data;
+    }
+    if constexpr(Path == TransferPath::HOST_TO_DEVICE || Path == TransferPath::HOST_READ) {
+      generateInput(host_data, bytes, getPattern);
+    }
+
+    if constexpr(reads_device) {
+      device_src = s::malloc_device<unsigned char>(bytes, args.device_queue);
+      std::vector<unsigned char> input(bytes);
+      generateInput(input.data(), bytes, getPattern);
+      args.device_queue.memcpy(device_src, input.data(), bytes).wait();
+    }
+    if constexpr(writes_device) {
+      device_dst = s::malloc_device<unsigned char>(bytes, args.device_queue);
+    }
+  }
+
+  void run(std::vector<s::event>& events) {
+    if constexpr(Path == TransferPath::HOST_TO_DEVICE) {
+      events.push_back(args.device_queue.memcpy(device_dst, host_data, bytes));
+    } else if constexpr(Path == TransferPath::DEVICE_TO_HOST) {
+      events.push_back(args.device_queue.memcpy(host_data, device_src, bytes));
+    } else if constexpr(Path == TransferPath::DEVICE_TO_DEVICE) {
+      events.push_back(args.device_queue.memcpy(device_dst, device_src, bytes));
+    } else {
+      // Every work item copies one 8 byte word, or the remaining bytes of the last one
+      const unsigned char* src = host_data;
+      unsigned char* dst = device_dst;
+      const std::size_t size = bytes;
+      const std::size_t num_words = (size + 7) / 8;
+      events.push_back(args.device_queue.parallel_for<TransferSweepHostReadKernel<Memory>>(
+          s::range<1>{num_words}, [=](s::id<1> gid) {
+            const std::size_t begin = gid[0] * 8;
+            if(begin + 8 <= size) {
+              *reinterpret_cast<std::uint64_t*>(dst + begin) = *reinterpret_cast<const std::uint64_t*>(src + begin);
+            } else {
+              for(std::size_t i = begin; i < size; ++i) dst[i] = src[i];
+            }
+          }));
+    }
+  }
+
+  static ThroughputMetric getThroughputMetric(const BenchmarkArgs& args) {
+    return {getTransferBytes(args) / 1024.0 / 1024.0 / 1024.0, "GiB"};
+  }
+
+  static double getTransferBytes(const BenchmarkArgs& args) { return static_cast<double>(args.problem_size); }
+
+  bool verify(VerificationSetting&) {
+    std::vector<unsigned char> result;
+    const unsigned char* output = host_data;
+    if constexpr(writes_device) {
+      result.resize(bytes);
+      args.device_queue.memcpy(result.data(), device_dst, bytes).wait();
+      output = result.data();
+    }
+    for(std::size_t i = 0; i < bytes; ++i) {
+      if(output[i] != getPattern(i))
+        return false;
+    }
+    return true;
+  }
+
+  static constexpr bool idempotent = true;
+
+  static std::string getBenchmarkName(BenchmarkArgs& args) {
+    std::stringstream name;
+    name << "MicroBench_TransferSweep_";
+    switch(Path) {
+    case TransferPath::HOST_TO_DEVICE: name << "H2D"; break;
+    case TransferPath::DEVICE_TO_HOST: name << "D2H"; break;
+    case TransferPath::DEVICE_TO_DEVICE: name << "D2D"; break;
+    case TransferPath::HOST_READ: name << "HostRead"; break;
+    }
+    if constexpr(Memory == HostMemory::PAGEABLE)
+      name << "_Pageable";
+    if constexpr(Memory == HostMemory::PINNED)
+      name << "_Pinned";
+    return name.str();
+  }
+};
+
+SYCL_BENCH_SUITE(transfer_sweep, "micro", app) {
+  app.run<MicroBenchTransferSweep<TransferPath::HOST_TO_DEVICE, HostMemory::PAGEABLE>>();
+  app.run<MicroBenchTransferSweep<TransferPath::HOST_TO_DEVICE, HostMemory::PINNED>>();
+
+  app.run<MicroBenchTransferSweep<TransferPath::DEVICE_TO_HOST, HostMemory::PAGEABLE>>();
+  app.run<MicroBenchTransferSweep<TransferPath::DEVICE_TO_HOST, HostMemory::PINNED>>();
+
+  app.run<MicroBenchTransferSweep<TransferPath::DEVICE_TO_DEVICE, HostMemory::NONE>>();
+
+  // Kernels can only access pageable host memory if the device supports system allocations
+  if(app.deviceHasAspect(s::aspect::usm_system_allocations))
+    app.run<MicroBenchTransferSweep<TransferPath::HOST_READ, HostMemory::PAGEABLE>>();
+  app.run<MicroBenchTransferSweep<TransferPath::HOST_READ, HostMemory::PINNED>>();
+}
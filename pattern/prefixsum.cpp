@@ -1 +1,443 @@
-TODO : SYCL code with a prefix sum
+#include "common.h"
+#include "polybenchUtilFuncts.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace s = sycl;
+
+/**
+ * COPY: vectorized copy with the launch configuration of the scans, as the bandwidth bound to compare them to
+ * REDUCE_THEN_SCAN: tile sums, a single work group scanning them, then scanning the tiles with their offsets
+ * BLELLOCH: work-efficient scan of every tile in local memory, scan of the tile sums, then adding the offsets
+ * DECOUPLED_LOOK_BACK: single pass, every tile obtains its offset from the status of its predecessors
+ * GROUP_ALGORITHMS: structured like BLELLOCH, using exclusive_scan_over_group and joint_exclusive_scan
+ */
+enum class PrefixSumAlgorithm { COPY, REDUCE_THEN_SCAN, BLELLOCH, DECOUPLED_LOOK_BACK, GROUP_ALGORITHMS };
+
+template <typename T, PrefixSumAlgorithm Algorithm, int Pass>
+class PrefixSumKernel;
+
+// Reduces value over the work group via local memory, returning the total to all work items
+template <typename T>
+T groupReduceLocal(const s::nd_item<1>& item, const s::local_accessor<T, 1>& scratch, T value) {
+  const std::size_t lid = item.get_local_id(0);
+  const std::size_t group_size = item.get_local_range(0);
+  scratch[lid] = value;
+  for(std::size_t i = group_size / 2; i > 0; i /= 2) {
+    s::group_barrier(item.get_group());
+    if(lid < i)
+      scratch[lid] += scratch[lid + i];
+  }
+  s::group_barrier(item.get_group());
+  const T total = scratch[0];
+  s::group_barrier(item.get_group());
+  return total;
+}
+
+/**
+ * Blelloch's work-efficient exclusive scan of value over the work group in local memory: an up-sweep
+ * building partial sums in place, followed by a down-sweep distributing them. Returns the exclusive
+ * prefix of the work item and the total of the work group. The work group size must be a power of two.
+ */
+template <typename T>
+T groupExclusiveScanLocal(const s::nd_item<1>& item, const s::local_accessor<T, 1>& scratch, T value, T& total) {
+  const std::size_t lid = item.get_local_id(0);
+  const std::size_t group_size = item.get_local_range(0);
+  scratch[lid] = value;
+  for(std::size_t offset = 1; offset < group_size; offset *= 2) {
+    s::group_barrier(item.get_group());
+    const std::size_t i = (lid + 1) * offset * 2 - 1;
+    if(i < group_size)
+      scratch[i] += scratch[i - offset];
+  }
+  s::group_barrier(item.get_group());
+  total = scratch[group_size - 1];
+  s::group_barrier(item.get_group());
+  if(lid == 0)
+    scratch[group_size - 1] = 0;
+  for(std::size_t offset = group_size / 2; offset > 0; offset /= 2) {
+    s::group_barrier(item.get_group());
+    const std::size_t i = (lid + 1) * offset * 2 - 1;
+    if(i < group_size) {
+      const T left = scratch[i - offset];
+      scratch[i - offset] = scratch[i];
+      scratch[i] += left;
+    }
+  }
+  s::group_barrier(item.get_group());
+  const T prefix = scratch[lid];
+  s::group_barrier(item.get_group());
+  return prefix;
+}
+
+/**
+ * Inclusive prefix sum of problem_size elements of type T. Every work item loads elements_per_item
+ * consecutive elements as one sycl::vec, so every work group processes a tile of local_size *
+ * elements_per_item elements. The data is padded with zeros to a multiple of the tile size.
+ *
+ * The throughput counts one read and one write of every element, the traffic of a copy, so the GiB/s of
+ * the scans can be compared directly to those of the COPY variant.
+ */
+template <typename T, PrefixSumAlgorithm Algorithm>
+class PrefixSum {
+public:
+  static constexpr int elements_per_item = 4;
+  using vec_type = s::vec<T, elements_per_item>;
+
+  PrefixSum(const BenchmarkArgs& args) : args{args} {
+    // Required by the tree reductions and scans in local memory
+    assert((args.local_size & (args.local_size - 1)) == 0);
+  }
+
+  // Local memory required per work group, used to bound the candidates of --autotune-local
+  static std::size_t getLocalMemoryUsage(const BenchmarkArgs& args) { return args.local_size * sizeof(T); }
+
+  void setup() {
+    const std::size_t tile_size = args.local_size * elements_per_item;
+    num_tiles = (args.problem_size + tile_size - 1) / tile_size;
+    padded_size = num_tiles * tile_size;
+
+    input.resize(padded_size);
+    generateInput(input.data(), args.problem_size, getInput);
+    std::fill(input.begin() + args.problem_size, input.end(), T{0});
+
+    input_buf.initialize(args.device_queue, static_cast<const T*>(input.data()), s::range<1>{padded_size});
+    output_buf.initialize(args.device_queue, s::range<1>{padded_size});
+    // Views of the same memory with one vec_type per work item, for vectorized loads and stores
+    const s::range<1> vec_range{padded_size / elements_per_item};
+    input_vec.emplace(input_buf.get().template reinterpret<vec_type, 1>(vec_range));
+    output_vec.emplace(output_buf.get().template reinterpret<vec_type, 1>(vec_range));
+
+    if constexpr(Algorithm == PrefixSumAlgorithm::DECOUPLED_LOOK_BACK) {
+      tile_counter_buf.initialize(args.device_queue, s::range<1>{1});
+      tile_flags_buf.initialize(args.device_queue, s::range<1>{num_tiles});
+      tile_sums_buf.initialize(args.device_queue, s::range<1>{num_tiles});
+      tile_offsets_buf.initialize(args.device_queue, s::range<1>{num_tiles});
+    } else if constexpr(Algorithm != PrefixSumAlgorithm::COPY) {
+      tile_sums_buf.initialize(args.device_queue, s::range<1>{num_tiles});
+      tile_offsets_buf.initialize(args.device_queue, s::range<1>{num_tiles});
+    }
+  }
+
+  void run(std::vector<s::event>& events) {
+    // Only the kernels of the algorithm are instantiated
+    if constexpr(Algorithm == PrefixSumAlgorithm::COPY) {
+      events.push_back(submitCopy());
+    } else if constexpr(Algorithm == PrefixSumAlgorithm::REDUCE_THEN_SCAN) {
+      events.push_back(submitTileReduce());
+      events.push_back(submitSpineScan());
+      events.push_back(submitTileScan());
+    } else if constexpr(Algorithm == PrefixSumAlgorithm::DECOUPLED_LOOK_BACK) {
+      submitResetTileStatus(events);
+      events.push_back(submitLookBackScan());
+    } else {
+      events.push_back(submitTileScan());
+      events.push_back(submitSpineScan());
+      events.push_back(submitPropagate());
+    }
+  }
+
+  bool verify(VerificationSetting&) {
+    auto output = output_buf.get_host_access();
+    if constexpr(Algorithm == PrefixSumAlgorithm::COPY) {
+      for(std::size_t i = 0; i < args.problem_size; ++i) {
+        if(output[i] != input[i])
+          return false;
+      }
+      return true;
+    } else if constexpr(std::is_integral_v<T>) {
+      std::vector<T> expected(args.problem_size);
+      std::inclusive_scan(input.begin(), input.begin() + args.problem_size, expected.begin());
+      for(std::size_t i = 0; i < args.problem_size; ++i) {
+        if(output[i] != expected[i])
+          return false;
+      }
+      return true;
+    } else {
+      // The device sums in a different order, compare to a reference computed in fp64
+      constexpr auto ERROR_THRESHOLD = 0.05;
+      double expected = 0.0;
+      for(std::size_t i = 0; i < args.problem_size; ++i) {
+        expected += static_cast<double>(input[i]);
+        if(percentDiff(expected, static_cast<double>(output[i])) > ERROR_THRESHOLD)
+          return false;
+      }
+      return true;
+    }
+  }
+
+  static ThroughputMetric getThroughputMetric(const BenchmarkArgs& args) {
+    return {2.0 * args.problem_size * sizeof(T) / 1024.0 / 1024.0 / 1024.0, "GiB"};
+  }
+
+  static constexpr bool idempotent = true;
+
+  static std::string getBenchmarkName(BenchmarkArgs& args) {
+    std::stringstream name;
+    name << "Pattern_PrefixSum_";
+    switch(Algorithm) {
+    case PrefixSumAlgorithm::COPY: name << "Copy_"; break;
+    case PrefixSumAlgorithm::REDUCE_THEN_SCAN: name << "ReduceThenScan_"; break;
+    case PrefixSumAlgorithm::BLELLOCH: name << "Blelloch_"; break;
+    case PrefixSumAlgorithm::DECOUPLED_LOOK_BACK: name << "DecoupledLookBack_"; break;
+    case PrefixSumAlgorithm::GROUP_ALGORITHMS: name << "GroupAlgorithms_"; break;
+    }
+    name << ReadableTypename<T>::name;
+    return name.str();
+  }
+
+private:
+  // Status of a tile in the decoupled look-back
+  static constexpr int tile_invalid = 0;
+  static constexpr int tile_aggregate_available = 1;
+  static constexpr int tile_prefix_available = 2;
+
+  using status_ref = s::atomic_ref<int, s::memory_order::acq_rel, s::memory_scope::device,
+      s::access::address_space::global_space>;
+
+  BenchmarkArgs args;
+  std::size_t num_tiles = 0;
+  std::size_t padded_size = 0;
+  HostVector<T> input;
+
+  PrefetchedBuffer<T, 1> input_buf;
+  PrefetchedBuffer<T, 1> output_buf;
+  std::optional<s::buffer<vec_type, 1>> input_vec;
+  std::optional<s::buffer<vec_type, 1>> output_vec;
+  // Sum of every tile and exclusive prefix of the tile sums (DECOUPLED_LOOK_BACK: inclusive prefix)
+  PrefetchedBuffer<T, 1> tile_sums_buf;
+  PrefetchedBuffer<T, 1> tile_offsets_buf;
+  PrefetchedBuffer<int, 1> tile_counter_buf;
+  PrefetchedBuffer<int, 1> tile_flags_buf;
+
+  // Small integers, so that the sums of int inputs do not overflow and those of floating point inputs stay exact
+  static T getInput(std::size_t i) { return static_cast<T>(i % 4); }
+
+  s::nd_range<1> getTileRange() const { return {num_tiles * args.local_size, args.local_size}; }
+
+  static T sumElements(const vec_type& v) {
+    T sum = v[0];
+    for(int e = 1; e < elements_per_item; ++e) sum += v[e];
+    return sum;
+  }
+
+  // Inclusive prefix sums of the elements of v, starting from prefix
+  static vec_type scanElements(const vec_type& v, T prefix) {
+    vec_type result;
+    for(int e = 0; e < elements_per_item; ++e) {
+      prefix += v[e];
+      result[e] = prefix;
+    }
+    return result;
+  }
+
+  s::event submitCopy() {
+    return args.device_queue.submit([&](s::handler& cgh) {
+      auto in = input_vec->template get_access<s::access::mode::read>(cgh);
+      auto out = output_vec->template get_access<s::access::mode::discard_write>(cgh);
+      cgh.parallel_for<PrefixSumKernel<T, Algorithm, 0>>(
+          getTileRange(), [=](s::nd_item<1> item) { out[item.get_global_id()] = in[item.get_global_id()]; });
+    });
+  }
+
+  // Writes the sum of every tile to tile_sums_buf
+  s::event submitTileReduce() {
+    return args.device_queue.submit([&](s::handler& cgh) {
+      auto in = input_vec->template get_access<s::access::mode::read>(cgh);
+      auto sums = tile_sums_buf.template get_access<s::access::mode::discard_write>(cgh);
+      s::local_accessor<T, 1> scratch{s::range<1>{args.local_size}, cgh};
+      cgh.parallel_for<PrefixSumKernel<T, Algorithm, 1>>(getTileRange(), [=](s::nd_item<1> item) {
+        const T total = groupReduceLocal(item, scratch, sumElements(in[item.get_global_id()]));
+        if(item.get_local_id(0) == 0)
+          sums[item.get_group(0)] = total;
+      });
+    });
+  }
+
+  // Exclusive scan of tile_sums_buf into tile_offsets_buf by a single work group
+  s::event submitSpineScan() {
+    return args.device_queue.submit([&](s::handler& cgh) {
+      auto sums = tile_sums_buf.template get_access<s::access::mode::read>(cgh);
+      auto offsets = tile_offsets_buf.template get_access<s::access::mode::discard_write>(cgh);
+      const std::size_t count = num_tiles;
+      const s::nd_range<1> single_group{args.local_size, args.local_size};
+
+      if constexpr(Algorithm == PrefixSumAlgorithm::GROUP_ALGORITHMS) {
+        cgh.parallel_for<PrefixSumKernel<T, Algorithm, 2>>(single_group, [=](s::nd_item<1> item) {
+          const T* first = sums.template get_multi_ptr<s::access::decorated::no>().get();
+          T* result = offsets.template get_multi_ptr<s::access::decorated::no>().get();
+          s::joint_exclusive_scan(item.get_group(), first, first + count, result, T{0}, s::plus<T>{});
+        });
+      } else {
+        s::local_accessor<T, 1> scratch{s::range<1>{args.local_size}, cgh};
+        cgh.parallel_for<PrefixSumKernel<T, Algorithm, 2>>(single_group, [=](s::nd_item<1> item) {
+          const std::size_t group_size = item.get_local_range(0);
+          // Total of all previous chunks, known to every work item
+          T carry = 0;
+          for(std::size_t begin = 0; begin < count; begin += group_size) {
+            const std::size_t i = begin + item.get_local_id(0);
+            T chunk_total;
+            const T prefix = groupExclusiveScanLocal(item, scratch, i < count ? sums[i] : T{0}, chunk_total);
+            if(i < count)
+              offsets[i] = carry + prefix;
+            carry += chunk_total;
+          }
+        });
+      }
+    });
+  }
+
+  /**
+   * Scans every tile. For REDUCE_THEN_SCAN, the tile offsets are already known and added, producing the final
+   * result. Otherwise the tile sums are written to tile_sums_buf for the spine scan.
+   */
+  s::event submitTileScan() {
+    return args.device_queue.submit([&](s::handler& cgh) {
+      auto in = input_vec->template get_access<s::access::mode::read>(cgh);
+      auto out = output_vec->template get_access<s::access::mode::discard_write>(cgh);
+
+      if constexpr(Algorithm == PrefixSumAlgorithm::REDUCE_THEN_SCAN) {
+        auto offsets = tile_offsets_buf.template get_access<s::access::mode::read>(cgh);
+        s::local_accessor<T, 1> scratch{s::range<1>{args.local_size}, cgh};
+        cgh.parallel_for<PrefixSumKernel<T, Algorithm, 3>>(getTileRange(), [=](s::nd_item<1> item) {
+          const vec_type v = in[item.get_global_id()];
+          T total;
+          const T prefix = groupExclusiveScanLocal(item, scratch, sumElements(v), total);
+          out[item.get_global_id()] = scanElements(v, offsets[item.get_group(0)] + prefix);
+        });
+      } else if constexpr(Algorithm == PrefixSumAlgorithm::BLELLOCH) {
+        auto sums = tile_sums_buf.template get_access<s::access::mode::discard_write>(cgh);
+        s::local_accessor<T, 1> scratch{s::range<1>{args.local_size}, cgh};
+        cgh.parallel_for<PrefixSumKernel<T, Algorithm, 3>>(getTileRange(), [=](s::nd_item<1> item) {
+          const vec_type v = in[item.get_global_id()];
+          T total;
+          const T prefix = groupExclusiveScanLocal(item, scratch, sumElements(v), total);
+          out[item.get_global_id()] = scanElements(v, prefix);
+          if(item.get_local_id(0) == 0)
+            sums[item.get_group(0)] = total;
+        });
+      } else if constexpr(Algorithm == PrefixSumAlgorithm::GROUP_ALGORITHMS) {
+        auto sums = tile_sums_buf.template get_access<s::access::mode::discard_write>(cgh);
+        cgh.parallel_for<PrefixSumKernel<T, Algorithm, 3>>(getTileRange(), [=](s::nd_item<1> item) {
+          const auto group = item.get_group();
+          const vec_type v = in[item.get_global_id()];
+          const T sum = sumElements(v);
+          const T prefix = s::exclusive_scan_over_group(group, sum, s::plus<T>{});
+          out[item.get_global_id()] = scanElements(v, prefix);
+          const T total = s::group_broadcast(group, prefix + sum, group.get_local_linear_range() - 1);
+          if(item.get_local_id(0) == 0)
+            sums[item.get_group(0)] = total;
+        });
+      }
+    });
+  }
+
+  // Adds the tile offsets to the scanned tiles
+  s::event submitPropagate() {
+    return args.device_queue.submit([&](s::handler& cgh) {
+      auto out = output_vec->template get_access<s::access::mode::read_write>(cgh);
+      auto offsets = tile_offsets_buf.template get_access<s::access::mode::read>(cgh);
+      cgh.parallel_for<PrefixSumKernel<T, Algorithm, 4>>(getTileRange(), [=](s::nd_item<1> item) {
+        out[item.get_global_id()] += offsets[item.get_group(0)];
+      });
+    });
+  }
+
+  // The tile status is consumed by every run, reset it before the scan
+  void submitResetTileStatus(std::vector<s::event>& events) {
+    events.push_back(args.device_queue.submit([&](s::handler& cgh) {
+      auto counter = tile_counter_buf.template get_access<s::access::mode::discard_write>(cgh);
+      cgh.fill(counter, 0);
+    }));
+    events.push_back(args.device_queue.submit([&](s::handler& cgh) {
+      auto flags = tile_flags_buf.template get_access<s::access::mode::discard_write>(cgh);
+      cgh.fill(flags, tile_invalid);
+    }));
+  }
+
+  /**
+   * Single-pass scan with decoupled look-back (Merrill and Garland, "Single-pass Parallel Prefix Scan with
+   * Decoupled Look-back"). Work groups obtain their tiles in launch order from an atomic counter, so that
+   * all predecessors of a tile have started and the look-back cannot wait for a work group that is not
+   * scheduled. Every tile publishes its sum (aggregate) as soon as it is known, and its inclusive prefix once
+   * its predecessors are known. The look-back sums the aggregates of the predecessors until it finds an
+   * inclusive prefix, so tiles rarely wait for the whole chain. Statuses are published with release stores
+   * and read with acquire loads, which order the accesses to the sums and prefixes.
+   */
+  s::event submitLookBackScan() {
+    return args.device_queue.submit([&](s::handler& cgh) {
+      auto in = input_vec->template get_access<s::access::mode::read>(cgh);
+      auto out = output_vec->template get_access<s::access::mode::discard_write>(cgh);
+      auto counter = tile_counter_buf.template get_access<s::access::mode::read_write>(cgh);
+      auto flags = tile_flags_buf.template get_access<s::access::mode::read_write>(cgh);
+      auto aggregates = tile_sums_buf.template get_access<s::access::mode::read_write>(cgh);
+      auto prefixes = tile_offsets_buf.template get_access<s::access::mode::read_write>(cgh);
+      s::local_accessor<T, 1> scratch{s::range<1>{args.local_size}, cgh};
+      s::local_accessor<std::size_t, 1> tile_index{s::range<1>{1}, cgh};
+      s::local_accessor<T, 1> tile_prefix{s::range<1>{1}, cgh};
+
+      cgh.parallel_for<PrefixSumKernel<T, Algorithm, 5>>(getTileRange(), [=](s::nd_item<1> item) {
+        const std::size_t lid = item.get_local_id(0);
+        if(lid == 0)
+          tile_index[0] = status_ref{counter[0]}.fetch_add(1);
+        s::group_barrier(item.get_group());
+        const std::size_t tile = tile_index[0];
+        const std::size_t i = tile * item.get_local_range(0) + lid;
+
+        const vec_type v = in[i];
+        T total;
+        const T prefix = groupExclusiveScanLocal(item, scratch, sumElements(v), total);
+
+        if(lid == 0) {
+          T exclusive = 0;
+          if(tile > 0) {
+            aggregates[tile] = total;
+            status_ref{flags[tile]}.store(tile_aggregate_available);
+            for(std::size_t predecessor = tile - 1;;) {
+              const int status = status_ref{flags[predecessor]}.load();
+              if(status == tile_prefix_available) {
+                exclusive += prefixes[predecessor];
+                break;
+              }
+              if(status == tile_aggregate_available) {
+                exclusive += aggregates[predecessor];
+                --predecessor;
+              }
+            }
+          }
+          prefixes[tile] = exclusive + total;
+          status_ref{flags[tile]}.store(tile_prefix_available);
+          tile_prefix[0] = exclusive;
+        }
+        s::group_barrier(item.get_group());
+        out[i] = scanElements(v, tile_prefix[0] + prefix);
+      });
+    });
+  }
+};
+
+template <typename T>
+void runPrefixSums(BenchmarkApp& app) {
+  app.run<PrefixSum<T, PrefixSumAlgorithm::COPY>>();
+  app.run<PrefixSum<T, PrefixSumAlgorithm::REDUCE_THEN_SCAN>>();
+  app.run<PrefixSum<T, PrefixSumAlgorithm::BLELLOCH>>();
+  app.run<PrefixSum<T, PrefixSumAlgorithm::GROUP_ALGORITHMS>>();
+  // The look-back relies on acquire and release ordering between work groups
+  if(app.deviceSupportsAtomicMemoryOrder(s::memory_order::acq_rel))
+    app.run<PrefixSum<T, PrefixSumAlgorithm::DECOUPLED_LOOK_BACK>>();
+}
+
+SYCL_BENCH_SUITE(prefixsum, "pattern", app) {
+  if(app.shouldRunNDRangeKernels()) {
+    runPrefixSums<int>(app);
+    runPrefixSums<float>(app);
+    if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
+      runPrefixSums<double>(app);
+    }
+  }
+}
@@ -5,32 +5,40 @@
 #include <cassert>
 #include <iostream>
 #include <numeric>
+#include <stdexcept>
 #include <vector>
 
 using namespace sycl;
 
-template <typename T>
+template <typename T, MemoryBackend Backend>
 class ReductionKernelNDRange;
-template <typename T>
+template <typename T, MemoryBackend Backend>
 class ReductionKernelHierarchical;
 
-template <typename T>
+template <typename T, MemoryBackend Backend>
 class Reduction {
 protected:
-  std::vector<T> _input;
+  using Data = DeviceData<T, 1, Backend>;
+
+  HostVector<T> _input;
   BenchmarkArgs _args;
 
-  PrefetchedBuffer<T, 1> _input_buff;
-  PrefetchedBuffer<T, 1> _output_buff;
-  sycl::buffer<T, 1>* _final_output_buff;
+  Data _input_buff;
+  Data _output_buff;
+  Data* _final_output_buff;
   T _result;
 
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Reduction(const BenchmarkArgs& args) : _args{args} { assert(_args.problem_size % _args.local_size == 0); }
 
-  void generate_input(std::vector<T>& out) {
+  // Local memory required per work group, used to bound the candidates of --autotune-local
+  static std::size_t getLocalMemoryUsage(const BenchmarkArgs& args) { return args.local_size * sizeof(T); }
+
+  void generate_input(HostVector<T>& out) {
     out.resize(_args.problem_size);
-    for(std::size_t i = 0; i < out.size(); ++i) out[i] = static_cast<T>(i);
+    generateInput(out.data(), out.size(), [](std::size_t i) { return static_cast<T>(i); });
   }
 
   void setup() {
@@ -43,15 +51,13 @@ public:
 
 
   void submit_ndrange(std::vector<sycl::event>& events) {
-    this->submit([this, &events](sycl::buffer<T, 1>* input, sycl::buffer<T, 1>* output, const size_t reduction_size,
-                     const size_t num_groups) {
+    this->submit([this, &events](Data* input, Data* output, const size_t reduction_size, const size_t num_groups) {
       events.push_back(this->local_reduce_ndrange(input, output, reduction_size, num_groups));
     });
   }
 
   void submit_hierarchical(std::vector<sycl::event>& events) {
-    this->submit([this, &events](sycl::buffer<T, 1>* input, sycl::buffer<T, 1>* output, const size_t reduction_size,
-                     const size_t num_groups) {
+    this->submit([this, &events](Data* input, Data* output, const size_t reduction_size, const size_t num_groups) {
       events.push_back(this->local_reduce_hierarchical(input, output, reduction_size, num_groups));
     });
   }
@@ -70,8 +76,12 @@ public:
 private:
   template <class Kernel_invocation_function>
   void submit(Kernel_invocation_function kernel) {
-    sycl::buffer<T, 1>* input_buff = &_input_buff.get();
-    sycl::buffer<T, 1>* output_buff = &_output_buff.get();
+    // With a single work item per group, the number of partial results would never decrease
+    if(_args.local_size < 2)
+      throw std::invalid_argument{"Reduction requires a local size of at least 2"};
+
+    Data* input_buff = &_input_buff;
+    Data* output_buff = &_output_buff;
 
     size_t current_reduction_size = _args.problem_size;
     size_t current_num_groups = _args.problem_size / _args.local_size;
@@ -96,8 +106,8 @@ private:
     _final_output_buff = output_buff;
   }
 
-  sycl::event local_reduce_ndrange(sycl::buffer<T, 1>* input, sycl::buffer<T, 1>* output, const size_t reduction_size,
-      const std::size_t num_groups) {
+  sycl::event local_reduce_ndrange(
+      Data* input, Data* output, const size_t reduction_size, const std::size_t num_groups) {
     return _args.device_queue.submit([&](sycl::handler& cgh) {
       sycl::nd_range<1> ndrange{num_groups * _args.local_size, _args.local_size};
 
@@ -108,7 +118,7 @@ private:
       auto scratch = sycl::local_accessor<T, 1>{_args.local_size, cgh};
       const int group_size = _args.local_size;
 
-      cgh.parallel_for<ReductionKernelNDRange<T>>(ndrange, [=](sycl::nd_item<1> item) {
+      cgh.parallel_for<ReductionKernelNDRange<T, Backend>>(ndrange, [=](sycl::nd_item<1> item) {
         const int lid = item.get_local_id(0);
         const auto gid = item.get_global_id();
 
@@ -125,8 +135,8 @@ private:
     }); // submit
   }
 
-  sycl::event local_reduce_hierarchical(sycl::buffer<T, 1>* input, sycl::buffer<T, 1>* output,
-      const size_t reduction_size, const std::size_t num_groups) {
+  sycl::event local_reduce_hierarchical(
+      Data* input, Data* output, const size_t reduction_size, const std::size_t num_groups) {
     return _args.device_queue.submit([&](sycl::handler& cgh) {
       using namespace sycl::access;
 
@@ -137,7 +147,7 @@ private:
 
       const int group_size = _args.local_size;
 
-      cgh.parallel_for_work_group<ReductionKernelHierarchical<T>>(
+      cgh.parallel_for_work_group<ReductionKernelHierarchical<T, Backend>>(
           sycl::range<1>{num_groups}, sycl::range<1>{_args.local_size}, [=](sycl::group<1> grp) {
             grp.parallel_for_work_item([&](sycl::h_item<1> idx) {
               const int lid = idx.get_local_id(0);
@@ -167,10 +177,10 @@ private:
   }
 };
 
-template <class T>
-class ReductionNDRange : public Reduction<T> {
+template <class T, MemoryBackend Backend = MemoryBackend::buffer>
+class ReductionNDRange : public Reduction<T, Backend> {
 public:
-  ReductionNDRange(const BenchmarkArgs& args) : Reduction<T>{args} {}
+  ReductionNDRange(const BenchmarkArgs& args) : Reduction<T, Backend>{args} {}
 
   void run(std::vector<sycl::event>& events) { this->submit_ndrange(events); }
 
@@ -182,10 +192,10 @@ public:
   }
 };
 
-template <class T>
-class ReductionHierarchical : public Reduction<T> {
+template <class T, MemoryBackend Backend = MemoryBackend::buffer>
+class ReductionHierarchical : public Reduction<T, Backend> {
 public:
-  ReductionHierarchical(const BenchmarkArgs& args) : Reduction<T>{args} {}
+  ReductionHierarchical(const BenchmarkArgs& args) : Reduction<T, Backend>{args} {}
 
   void run(std::vector<sycl::event>& events) {
     this->submit_hierarchical(events);
@@ -201,26 +211,25 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-
+SYCL_BENCH_SUITE(reduction, "pattern", app) {
   // Using short will lead to overflow even for
   // small problem sizes
   // app.run< ReductionNDRange<short>>();
-  if(app.shouldRunNDRangeKernels()) {
-    app.run<ReductionNDRange<int>>();
-    app.run<ReductionNDRange<long long>>();
-    app.run<ReductionNDRange<float>>();
+  app.forEachMemoryBackend([&](auto backend) {
+    if(app.shouldRunNDRangeKernels()) {
+      app.run<ReductionNDRange<int, backend>>();
+      app.run<ReductionNDRange<long long, backend>>();
+      app.run<ReductionNDRange<float, backend>>();
+      if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
+        app.run<ReductionNDRange<double, backend>>();
+      }
+    }
+    // app.run< ReductionHierarchical<short>>();
+    app.run<ReductionHierarchical<int, backend>>();
+    app.run<ReductionHierarchical<long long, backend>>();
+    app.run<ReductionHierarchical<float, backend>>();
     if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
-      app.run<ReductionNDRange<double>>();
+      app.run<ReductionHierarchical<double, backend>>();
     }
-  }
-  // app.run< ReductionHierarchical<short>>();
-  app.run<ReductionHierarchical<int>>();
-  app.run<ReductionHierarchical<long long>>();
-  app.run<ReductionHierarchical<float>>();
-  if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
-    app.run<ReductionHierarchical<double>>();
-  }
-  return 0;
+  });
 }
@@ -8,9 +8,9 @@
 using namespace sycl;
 
 template <typename T>
-class ReductionKernelNDRange;
+class SegmentedReductionKernelNDRange;
 template <typename T>
-class ReductionKernelHierarchical;
+class SegmentedReductionKernelHierarchical;
 
 template <typename T>
 class SegmentedReduction {
@@ -22,6 +22,9 @@ protected:
 public:
   SegmentedReduction(const BenchmarkArgs& args) : _args{args} { assert(_args.problem_size % _args.local_size == 0); }
 
+  // Local memory required per work group, used to bound the candidates of --autotune-local
+  static std::size_t getLocalMemoryUsage(const BenchmarkArgs& args) { return args.local_size * sizeof(T); }
+
   void generate_input(std::vector<T>& out) {
     out.resize(_args.problem_size);
     for(std::size_t i = 0; i < out.size(); ++i) out[i] = static_cast<T>(i);
@@ -43,7 +46,7 @@ public:
 
       const int group_size = _args.local_size;
 
-      cgh.parallel_for<ReductionKernelNDRange<T>>(ndrange, [=](sycl::nd_item<1> item) {
+      cgh.parallel_for<SegmentedReductionKernelNDRange<T>>(ndrange, [=](sycl::nd_item<1> item) {
         const int lid = item.get_local_id(0);
         const auto gid = item.get_global_id();
 
@@ -69,7 +72,7 @@ public:
 
       const int group_size = _args.local_size;
 
-      cgh.parallel_for_work_group<ReductionKernelHierarchical<T>>(sycl::range<1>{_args.problem_size / _args.local_size},
+      cgh.parallel_for_work_group<SegmentedReductionKernelHierarchical<T>>(sycl::range<1>{_args.problem_size / _args.local_size},
           sycl::range<1>{_args.local_size}, [=](sycl::group<1> grp) {
             grp.parallel_for_work_item([&](sycl::h_item<1> idx) {
               const int lid = idx.get_local_id(0);
@@ -162,9 +165,7 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-
+SYCL_BENCH_SUITE(segmentedreduction, "pattern", app) {
   if(app.shouldRunNDRangeKernels()) {
     app.run<SegmentedReductionNDRange<short>>();
     app.run<SegmentedReductionNDRange<int>>();
@@ -182,5 +183,4 @@ int main(int argc, char** argv) {
   if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
     app.run<SegmentedReductionHierarchical<double>>();
   }
-  return 0;
 }
@@ -10,20 +10,14 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class conv2D;
 
-void init(DATA_TYPE* A, size_t size) {
-  const auto NI = size;
-  const auto NJ = size;
-
-  for(size_t i = 0; i < NI; ++i) {
-    for(size_t j = 0; j < NJ; ++j) {
-      A[i * NJ + j] = (float)rand() / (float)RAND_MAX;
-    }
-  }
+static void init(DATA_TYPE* A, size_t size) {
+  generateUniform(A, size * size, DATA_TYPE{0}, DATA_TYPE{1}, 1);
 }
 
-void conv2D(DATA_TYPE* A, DATA_TYPE* B, size_t size) {
+static void conv2D(DATA_TYPE* A, DATA_TYPE* B, size_t size) {
   const auto NI = size;
   const auto NJ = size;
 
@@ -41,8 +35,11 @@ void conv2D(DATA_TYPE* A, DATA_TYPE* B, size_t size) {
   }
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_2DConvolution {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_2DConvolution(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -59,10 +56,10 @@ public:
     using namespace sycl;
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto A = A_buffer.get_access<access::mode::read>(cgh);
-      auto B = B_buffer.get_access<access::mode::discard_write>(cgh);
+      auto A = A_buffer.template get_access<access::mode::read>(cgh);
+      auto B = B_buffer.template get_access<access::mode::discard_write>(cgh);
 
-      cgh.parallel_for<class conv2D>(B_buffer.get_range(), [=, size_ = size](item<2> item) {
+      cgh.parallel_for<conv2D<Backend>>(B_buffer.get_range(), [=, size_ = size](item<2> item) {
         const auto i = item[0];
         const auto j = item[1];
 
@@ -79,6 +76,29 @@ public:
     }));
   }
 
+  // Parallel CPU implementation of run()
+  void runNative() {
+    if(B_native.empty())
+      B_native.resize(size * size);
+
+    NativeThreadPool::get().parallelFor(size - 2, [&](size_t begin, size_t end) {
+      const DATA_TYPE c11 = +0.2, c21 = +0.5, c31 = -0.8;
+      const DATA_TYPE c12 = -0.3, c22 = +0.6, c32 = -0.9;
+      const DATA_TYPE c13 = +0.4, c23 = +0.7, c33 = +0.10;
+
+      for(size_t i = begin + 1; i < end + 1; i++) {
+        const DATA_TYPE* above = &A[(i - 1) * size];
+        const DATA_TYPE* row = &A[i * size];
+        const DATA_TYPE* below = &A[(i + 1) * size];
+        DATA_TYPE* b = &B_native[i * size];
+        for(size_t j = 1; j < size - 1; j++) {
+          b[j] = c11 * above[j - 1] + c12 * row[j - 1] + c13 * below[j - 1] + c21 * above[j] + c22 * row[j] +
+                 c23 * below[j] + c31 * above[j + 1] + c32 * row[j + 1] + c33 * below[j + 1];
+        }
+      }
+    });
+  }
+
   bool verify(VerificationSetting&) {
     constexpr auto ERROR_THRESHOLD = 0.05;
 
@@ -100,21 +120,22 @@ public:
     return true;
   }
 
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) { return "Polybench_2DConvolution"; }
 
 private:
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> A;
-  std::vector<DATA_TYPE> B;
+  HostVector<DATA_TYPE> A;
+  HostVector<DATA_TYPE> B;
+  HostVector<DATA_TYPE> B_native;
 
-  PrefetchedBuffer<DATA_TYPE, 2> A_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> B_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> A_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> B_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_2DConvolution>();
-  return 0;
+SYCL_BENCH_SUITE(2DConvolution, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_2DConvolution<backend>>(); });
 }
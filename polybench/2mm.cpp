@@ -10,41 +10,52 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class Polybench_2mm_2;
+template <MemoryBackend Backend>
 class Polybench_2mm_1;
 
-void init_array(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, DATA_TYPE* D, size_t size) {
-  const auto NI = size;
-  const auto NJ = size;
-  const auto NK = size;
-  const auto NL = size;
-
-  for(size_t i = 0; i < NI; i++) {
-    for(size_t j = 0; j < NK; j++) {
-      A[i * NI + j] = ((DATA_TYPE)i * j) / NI;
-    }
+// Initial values of the size x size input matrices by linear index, on the host and on the device (--no-host-mirror)
+struct Mm2InputA {
+  size_t size;
+  DATA_TYPE operator()(size_t idx) const {
+    const auto i = idx / size, j = idx % size;
+    return ((DATA_TYPE)i * j) / size;
   }
+};
 
-  for(size_t i = 0; i < NK; i++) {
-    for(size_t j = 0; j < NJ; j++) {
-      B[i * NK + j] = ((DATA_TYPE)i * (j + 1)) / NJ;
-    }
+struct Mm2InputB {
+  size_t size;
+  DATA_TYPE operator()(size_t idx) const {
+    const auto i = idx / size, j = idx % size;
+    return ((DATA_TYPE)i * (j + 1)) / size;
   }
+};
 
-  for(size_t i = 0; i < NL; i++) {
-    for(size_t j = 0; j < NJ; j++) {
-      C[i * NL + j] = ((DATA_TYPE)i * (j + 3)) / NL;
-    }
+struct Mm2InputC {
+  size_t size;
+  DATA_TYPE operator()(size_t idx) const {
+    const auto i = idx / size, j = idx % size;
+    return ((DATA_TYPE)i * (j + 3)) / size;
   }
+};
 
-  for(size_t i = 0; i < NI; i++) {
-    for(size_t j = 0; j < NL; j++) {
-      D[i * NL + j] = ((DATA_TYPE)i * (j + 2)) / NK;
-    }
+struct Mm2InputD {
+  size_t size;
+  DATA_TYPE operator()(size_t idx) const {
+    const auto i = idx / size, j = idx % size;
+    return ((DATA_TYPE)i * (j + 2)) / size;
   }
+};
+
+static void init_array(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, DATA_TYPE* D, size_t size) {
+  generateInput(A, size * size, Mm2InputA{size});
+  generateInput(B, size * size, Mm2InputB{size});
+  generateInput(C, size * size, Mm2InputC{size});
+  generateInput(D, size * size, Mm2InputD{size});
 }
 
-void mm2_cpu(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, DATA_TYPE* D, DATA_TYPE* E, size_t size) {
+static void mm2_cpu(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, DATA_TYPE* D, DATA_TYPE* E, size_t size) {
   const auto NI = size;
   const auto NJ = size;
   const auto NK = size;
@@ -68,18 +79,27 @@ void mm2_cpu(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, DATA_TYPE* D, DATA_TYPE*
   }
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_2mm {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_2mm(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
-    A.resize(size * size);
-    B.resize(size * size);
-    C.resize(size * size);
-    D.resize(size * size);
-    E.resize(size * size);
+    const sycl::range<2> range{size, size};
+    if(DeviceInit::isEnabled()) {
+      // No host arrays; E is written by run() before it is read
+      A_buffer.initialize(args.device_queue, range, Mm2InputA{size});
+      B_buffer.initialize(args.device_queue, range, Mm2InputB{size});
+      C_buffer.initialize(args.device_queue, range, Mm2InputC{size});
+      D_buffer.initialize(args.device_queue, range, Mm2InputD{size});
+      E_buffer.initialize(args.device_queue, range);
+      return;
+    }
 
-    init_array(A.data(), B.data(), C.data(), D.data(), size);
+    initHostArrays();
+    E.resize(size * size);
 
     A_buffer.initialize(args.device_queue, A.data(), sycl::range<2>(size, size));
     B_buffer.initialize(args.device_queue, B.data(), sycl::range<2>(size, size));
@@ -92,11 +112,11 @@ public:
     using namespace sycl;
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto A = A_buffer.get_access<access::mode::read>(cgh);
-      auto B = B_buffer.get_access<access::mode::read>(cgh);
-      auto C = C_buffer.get_access<access::mode::read_write>(cgh);
+      auto A = A_buffer.template get_access<access::mode::read>(cgh);
+      auto B = B_buffer.template get_access<access::mode::read>(cgh);
+      auto C = C_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<Polybench_2mm_1>(C_buffer.get_range(), [=, size_ = size](item<2> item) {
+      cgh.parallel_for<Polybench_2mm_1<Backend>>(C_buffer.get_range(), [=, size_ = size](item<2> item) {
         const auto i = item[0];
         const auto j = item[1];
 
@@ -107,11 +127,11 @@ public:
     }));
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto C = C_buffer.get_access<access::mode::read>(cgh);
-      auto D = D_buffer.get_access<access::mode::read>(cgh);
-      auto E = E_buffer.get_access<access::mode::discard_write>(cgh);
+      auto C = C_buffer.template get_access<access::mode::read>(cgh);
+      auto D = D_buffer.template get_access<access::mode::read>(cgh);
+      auto E = E_buffer.template get_access<access::mode::discard_write>(cgh);
 
-      cgh.parallel_for<Polybench_2mm_2>(E_buffer.get_range(), [=, size_ = size](item<2> item) {
+      cgh.parallel_for<Polybench_2mm_2<Backend>>(E_buffer.get_range(), [=, size_ = size](item<2> item) {
         const auto i = item[0];
         const auto j = item[1];
 
@@ -123,13 +143,63 @@ public:
     }));
   }
 
+  // Parallel CPU implementation of run(), accumulating into a copy of C
+  void runNative() {
+    if(A.empty())
+      initHostArrays();
+    if(C_native.empty()) {
+      C_native.assign(C.begin(), C.end());
+      E_native.resize(size * size);
+    }
+
+    auto& pool = NativeThreadPool::get();
+    pool.parallelFor(size, [&](size_t begin, size_t end) {
+      for(size_t i = begin; i < end; i++) {
+        DATA_TYPE* c = &C_native[i * size];
+        for(size_t k = 0; k < size; k++) {
+          const DATA_TYPE a = A[i * size + k];
+          const DATA_TYPE* b = &B[k * size];
+          for(size_t j = 0; j < size; j++) c[j] += a * b[j];
+        }
+      }
+    });
+    pool.parallelFor(size, [&](size_t begin, size_t end) {
+      for(size_t i = begin; i < end; i++) {
+        DATA_TYPE* e = &E_native[i * size];
+        for(size_t j = 0; j < size; j++) e[j] = 0;
+        for(size_t k = 0; k < size; k++) {
+          const DATA_TYPE c = C_native[i * size + k];
+          const DATA_TYPE* d = &D[k * size];
+          for(size_t j = 0; j < size; j++) e[j] += c * d[j];
+        }
+      }
+    });
+  }
+
+  void reset() {
+    // C is accumulated into by both run() and mm2_cpu(), restore its initial values
+    if(DeviceInit::isEnabled()) {
+      C_buffer.initialize(args.device_queue, sycl::range<2>(size, size), Mm2InputC{size});
+      return;
+    }
+    init_array(A.data(), B.data(), C.data(), D.data(), size);
+    C_buffer.initialize(args.device_queue, C.data(), sycl::range<2>(size, size));
+  }
+
   bool verify(VerificationSetting&) {
     constexpr auto ERROR_THRESHOLD = 0.05;
 
-    init_array(A.data(), B.data(), C.data(), D.data(), size);
+    if(DeviceInit::isEnabled())
+      return verifySamples(ERROR_THRESHOLD);
+
+    const auto E_cpu =
+        ReferenceCache::get().getOrCompute<DATA_TYPE>(getBenchmarkName(args), size, reference_version, [&]() {
+          init_array(A.data(), B.data(), C.data(), D.data(), size);
 
-    std::vector<DATA_TYPE> E_cpu(size * size);
-    mm2_cpu(A.data(), B.data(), C.data(), D.data(), E_cpu.data(), size);
+          std::vector<DATA_TYPE> E_cpu(size * size);
+          mm2_cpu(A.data(), B.data(), C.data(), D.data(), E_cpu.data(), size);
+          return E_cpu;
+        });
 
     auto E_acc = E_buffer.get_host_access();
 
@@ -147,24 +217,60 @@ public:
   static std::string getBenchmarkName(BenchmarkArgs& args) { return "Polybench_2mm"; }
 
 private:
+  static constexpr unsigned reference_version = 1;
+
+  void initHostArrays() {
+    A.resize(size * size);
+    B.resize(size * size);
+    C.resize(size * size);
+    D.resize(size * size);
+    init_array(A.data(), B.data(), C.data(), D.data(), size);
+  }
+
+  // Checks sampled elements of E against values recomputed from the generators, one row of C at a time
+  bool verifySamples(double threshold) {
+    const auto indices = DeviceInit::getSampleIndices(size * size);
+    const auto samples = E_buffer.gather_samples(args.device_queue, indices);
+
+    std::vector<DATA_TYPE> C_row(size);
+    size_t row = size;
+    for(size_t s = 0; s < indices.size(); ++s) {
+      const size_t i = indices[s] / size, j = indices[s] % size;
+      // The indices are sorted, so every row of C is only computed once
+      if(i != row) {
+        row = i;
+        for(size_t k = 0; k < size; k++) {
+          DATA_TYPE c = Mm2InputC{size}(i * size + k);
+          for(size_t l = 0; l < size; l++) c += Mm2InputA{size}(i * size + l) * Mm2InputB{size}(l * size + k);
+          C_row[k] = c;
+        }
+      }
+      DATA_TYPE e = 0;
+      for(size_t k = 0; k < size; k++) e += C_row[k] * Mm2InputD{size}(k * size + j);
+      if(percentDiff(e, samples[s]) > threshold)
+        return false;
+    }
+    return true;
+  }
+
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> A;
-  std::vector<DATA_TYPE> B;
-  std::vector<DATA_TYPE> C;
-  std::vector<DATA_TYPE> D;
-  std::vector<DATA_TYPE> E;
-
-  PrefetchedBuffer<DATA_TYPE, 2> A_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> B_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> C_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> D_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> E_buffer;
+  HostVector<DATA_TYPE> A;
+  HostVector<DATA_TYPE> B;
+  HostVector<DATA_TYPE> C;
+  HostVector<DATA_TYPE> D;
+  HostVector<DATA_TYPE> E;
+  HostVector<DATA_TYPE> C_native;
+  HostVector<DATA_TYPE> E_native;
+
+  DeviceData<DATA_TYPE, 2, Backend> A_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> B_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> C_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> D_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> E_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_2mm>();
-  return 0;
+SYCL_BENCH_SUITE(2mm, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_2mm<backend>>(); });
 }
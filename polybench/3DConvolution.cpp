@@ -10,9 +10,10 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class conv3D;
 
-void init(DATA_TYPE* A, size_t size) {
+static void init(DATA_TYPE* A, size_t size) {
   const auto NI = size;
   const auto NJ = size;
   const auto NK = size;
@@ -26,7 +27,7 @@ void init(DATA_TYPE* A, size_t size) {
   }
 }
 
-void conv3D(DATA_TYPE* A, DATA_TYPE* B, size_t size) {
+static void conv3D(DATA_TYPE* A, DATA_TYPE* B, size_t size) {
   const auto NI = size;
   const auto NJ = size;
   const auto NK = size;
@@ -58,8 +59,11 @@ void conv3D(DATA_TYPE* A, DATA_TYPE* B, size_t size) {
   }
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_3DConvolution {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_3DConvolution(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -76,10 +80,10 @@ public:
     using namespace sycl;
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto A = A_buffer.get_access<access::mode::read>(cgh);
-      auto B = B_buffer.get_access<access::mode::discard_write>(cgh);
+      auto A = A_buffer.template get_access<access::mode::read>(cgh);
+      auto B = B_buffer.template get_access<access::mode::discard_write>(cgh);
 
-      cgh.parallel_for<class conv3D>(B_buffer.get_range(), [=, size_ = size](item<3> item) {
+      cgh.parallel_for<conv3D<Backend>>(B_buffer.get_range(), [=, size_ = size](item<3> item) {
         const auto i = item[0];
         const auto j = item[1];
         const auto k = item[2];
@@ -127,21 +131,21 @@ public:
     return true;
   }
 
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) { return "Polybench_3DConvolution"; }
 
 private:
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> A;
-  std::vector<DATA_TYPE> B;
+  HostVector<DATA_TYPE> A;
+  HostVector<DATA_TYPE> B;
 
-  PrefetchedBuffer<DATA_TYPE, 3> A_buffer;
-  PrefetchedBuffer<DATA_TYPE, 3> B_buffer;
+  DeviceData<DATA_TYPE, 3, Backend> A_buffer;
+  DeviceData<DATA_TYPE, 3, Backend> B_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_3DConvolution>();
-  return 0;
+SYCL_BENCH_SUITE(3DConvolution, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_3DConvolution<backend>>(); });
 }
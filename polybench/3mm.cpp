@@ -10,43 +10,42 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class Polybench_3mm_1;
+template <MemoryBackend Backend>
 class Polybench_3mm_2;
+template <MemoryBackend Backend>
 class Polybench_3mm_3;
 
-void init_array(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, DATA_TYPE* D, size_t size) {
+static void init_array(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, DATA_TYPE* D, size_t size) {
   const auto NI = size;
   const auto NJ = size;
   const auto NK = size;
   const auto NL = size;
   const auto NM = size;
 
-  for(size_t i = 0; i < NI; i++) {
-    for(size_t j = 0; j < NK; j++) {
-      A[i * NK + j] = ((DATA_TYPE)i * j) / NI;
-    }
-  }
-
-  for(size_t i = 0; i < NK; i++) {
-    for(size_t j = 0; j < NJ; j++) {
-      B[i * NJ + j] = ((DATA_TYPE)i * (j + 1)) / NJ;
-    }
-  }
-
-  for(size_t i = 0; i < NJ; i++) {
-    for(size_t j = 0; j < NM; j++) {
-      C[i * NM + j] = ((DATA_TYPE)i * (j + 3)) / NL;
-    }
-  }
-
-  for(size_t i = 0; i < NM; i++) {
-    for(size_t j = 0; j < NL; j++) {
-      D[i * NL + j] = ((DATA_TYPE)i * (j + 2)) / NK;
-    }
-  }
+  generateInput(A, NI * NK, [=](size_t idx) {
+    const auto i = idx / NK, j = idx % NK;
+    return ((DATA_TYPE)i * j) / NI;
+  });
+
+  generateInput(B, NK * NJ, [=](size_t idx) {
+    const auto i = idx / NJ, j = idx % NJ;
+    return ((DATA_TYPE)i * (j + 1)) / NJ;
+  });
+
+  generateInput(C, NJ * NM, [=](size_t idx) {
+    const auto i = idx / NM, j = idx % NM;
+    return ((DATA_TYPE)i * (j + 3)) / NL;
+  });
+
+  generateInput(D, NM * NL, [=](size_t idx) {
+    const auto i = idx / NL, j = idx % NL;
+    return ((DATA_TYPE)i * (j + 2)) / NK;
+  });
 }
 
-void mm3_cpu(
+static void mm3_cpu(
     DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, DATA_TYPE* D, DATA_TYPE* E, DATA_TYPE* F, DATA_TYPE* G, size_t size) {
   const auto NI = size;
   const auto NJ = size;
@@ -85,8 +84,26 @@ void mm3_cpu(
   }
 }
 
+// Z := X*Y, parallelized over the rows of Z
+static void mm_native(const DATA_TYPE* X, const DATA_TYPE* Y, DATA_TYPE* Z, size_t size) {
+  NativeThreadPool::get().parallelFor(size, [&](size_t begin, size_t end) {
+    for(size_t i = begin; i < end; i++) {
+      DATA_TYPE* z = &Z[i * size];
+      for(size_t j = 0; j < size; j++) z[j] = 0;
+      for(size_t k = 0; k < size; k++) {
+        const DATA_TYPE x = X[i * size + k];
+        const DATA_TYPE* y = &Y[k * size];
+        for(size_t j = 0; j < size; j++) z[j] += x * y[j];
+      }
+    }
+  });
+}
+
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_3mm {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_3mm(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -113,11 +130,11 @@ public:
     using namespace sycl;
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto A = A_buffer.get_access<access::mode::read>(cgh);
-      auto B = B_buffer.get_access<access::mode::read>(cgh);
-      auto E = E_buffer.get_access<access::mode::read_write>(cgh);
+      auto A = A_buffer.template get_access<access::mode::read>(cgh);
+      auto B = B_buffer.template get_access<access::mode::read>(cgh);
+      auto E = E_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<Polybench_3mm_1>(E_buffer.get_range(), [=, size_ = size](item<2> item) {
+      cgh.parallel_for<Polybench_3mm_1<Backend>>(E_buffer.get_range(), [=, size_ = size](item<2> item) {
         const auto i = item[0];
         const auto j = item[1];
 
@@ -128,11 +145,11 @@ public:
     }));
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto C = C_buffer.get_access<access::mode::read>(cgh);
-      auto D = D_buffer.get_access<access::mode::read>(cgh);
-      auto F = F_buffer.get_access<access::mode::read_write>(cgh);
+      auto C = C_buffer.template get_access<access::mode::read>(cgh);
+      auto D = D_buffer.template get_access<access::mode::read>(cgh);
+      auto F = F_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<Polybench_3mm_2>(F_buffer.get_range(), [=, size_ = size](item<2> item) {
+      cgh.parallel_for<Polybench_3mm_2<Backend>>(F_buffer.get_range(), [=, size_ = size](item<2> item) {
         const auto i = item[0];
         const auto j = item[1];
 
@@ -143,11 +160,11 @@ public:
     }));
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto E = E_buffer.get_access<access::mode::read>(cgh);
-      auto F = F_buffer.get_access<access::mode::read>(cgh);
-      auto G = G_buffer.get_access<access::mode::read_write>(cgh);
+      auto E = E_buffer.template get_access<access::mode::read>(cgh);
+      auto F = F_buffer.template get_access<access::mode::read>(cgh);
+      auto G = G_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<Polybench_3mm_3>(F_buffer.get_range(), [=, size_ = size](item<2> item) {
+      cgh.parallel_for<Polybench_3mm_3<Backend>>(F_buffer.get_range(), [=, size_ = size](item<2> item) {
         const auto i = item[0];
         const auto j = item[1];
 
@@ -158,16 +175,39 @@ public:
     }));
   }
 
+  // Parallel CPU implementation of run()
+  void runNative() {
+    if(E_native.empty()) {
+      E_native.resize(size * size);
+      F_native.resize(size * size);
+      G_native.resize(size * size);
+    }
+    mm_native(A.data(), B.data(), E_native.data(), size);
+    mm_native(C.data(), D.data(), F_native.data(), size);
+    mm_native(E_native.data(), F_native.data(), G_native.data(), size);
+  }
+
+  void reset() {
+    // E, F and G are accumulated into by run(), restore their initial (zero) values
+    E_buffer.initialize(args.device_queue, E.data(), sycl::range<2>(size, size));
+    F_buffer.initialize(args.device_queue, F.data(), sycl::range<2>(size, size));
+    G_buffer.initialize(args.device_queue, G.data(), sycl::range<2>(size, size));
+  }
+
   bool verify(VerificationSetting&) {
     constexpr auto ERROR_THRESHOLD = 0.05;
 
-    init_array(A.data(), B.data(), C.data(), D.data(), size);
+    const auto G_cpu =
+        ReferenceCache::get().getOrCompute<DATA_TYPE>(getBenchmarkName(args), size, reference_version, [&]() {
+          init_array(A.data(), B.data(), C.data(), D.data(), size);
 
-    std::vector<DATA_TYPE> E_cpu(size * size);
-    std::vector<DATA_TYPE> F_cpu(size * size);
-    std::vector<DATA_TYPE> G_cpu(size * size);
+          std::vector<DATA_TYPE> E_cpu(size * size);
+          std::vector<DATA_TYPE> F_cpu(size * size);
+          std::vector<DATA_TYPE> G_cpu(size * size);
 
-    mm3_cpu(A.data(), B.data(), C.data(), D.data(), E_cpu.data(), F_cpu.data(), G_cpu.data(), size);
+          mm3_cpu(A.data(), B.data(), C.data(), D.data(), E_cpu.data(), F_cpu.data(), G_cpu.data(), size);
+          return G_cpu;
+        });
 
     auto G_acc = G_buffer.get_host_access();
 
@@ -185,28 +225,31 @@ public:
   static std::string getBenchmarkName(BenchmarkArgs& args) { return "Polybench_3mm"; }
 
 private:
+  static constexpr unsigned reference_version = 1;
+
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> A;
-  std::vector<DATA_TYPE> B;
-  std::vector<DATA_TYPE> C;
-  std::vector<DATA_TYPE> D;
-  std::vector<DATA_TYPE> E;
-  std::vector<DATA_TYPE> F;
-  std::vector<DATA_TYPE> G;
-
-  PrefetchedBuffer<DATA_TYPE, 2> A_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> B_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> C_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> D_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> E_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> F_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> G_buffer;
+  HostVector<DATA_TYPE> A;
+  HostVector<DATA_TYPE> B;
+  HostVector<DATA_TYPE> C;
+  HostVector<DATA_TYPE> D;
+  HostVector<DATA_TYPE> E;
+  HostVector<DATA_TYPE> F;
+  HostVector<DATA_TYPE> G;
+  HostVector<DATA_TYPE> E_native;
+  HostVector<DATA_TYPE> F_native;
+  HostVector<DATA_TYPE> G_native;
+
+  DeviceData<DATA_TYPE, 2, Backend> A_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> B_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> C_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> D_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> E_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> F_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> G_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_3mm>();
-  return 0;
+SYCL_BENCH_SUITE(3mm, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_3mm<backend>>(); });
 }
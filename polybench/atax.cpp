@@ -14,10 +14,12 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class Atax1;
+template <MemoryBackend Backend>
 class Atax2;
 
-void init_array(DATA_TYPE* x, DATA_TYPE* A, size_t size) {
+static void init_array(DATA_TYPE* x, DATA_TYPE* A, size_t size) {
   const auto NX = size;
   const auto NY = size;
 
@@ -29,7 +31,7 @@ void init_array(DATA_TYPE* x, DATA_TYPE* A, size_t size) {
   }
 }
 
-void atax_cpu(DATA_TYPE* A, DATA_TYPE* x, DATA_TYPE* y, DATA_TYPE* tmp, size_t size) {
+static void atax_cpu(DATA_TYPE* A, DATA_TYPE* x, DATA_TYPE* y, DATA_TYPE* tmp, size_t size) {
   const auto NX = size;
   const auto NY = size;
 
@@ -44,8 +46,11 @@ void atax_cpu(DATA_TYPE* A, DATA_TYPE* x, DATA_TYPE* y, DATA_TYPE* tmp, size_t s
   }
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_Atax {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_Atax(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -66,11 +71,11 @@ public:
     using namespace sycl;
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto A = A_buffer.get_access<access::mode::read>(cgh);
-      auto x = x_buffer.get_access<access::mode::read>(cgh);
-      auto tmp = tmp_buffer.get_access<access::mode::read_write>(cgh);
+      auto A = A_buffer.template get_access<access::mode::read>(cgh);
+      auto x = x_buffer.template get_access<access::mode::read>(cgh);
+      auto tmp = tmp_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<Atax1>(tmp_buffer.get_range(), [=, size_ = size](item<1> item) {
+      cgh.parallel_for<Atax1<Backend>>(tmp_buffer.get_range(), [=, size_ = size](item<1> item) {
         const auto i = item[0];
 
         for(size_t j = 0; j < size_; j++) {
@@ -80,11 +85,11 @@ public:
     }));
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto A = A_buffer.get_access<access::mode::read>(cgh);
-      auto y = y_buffer.get_access<access::mode::read_write>(cgh);
-      auto tmp = tmp_buffer.get_access<access::mode::read>(cgh);
+      auto A = A_buffer.template get_access<access::mode::read>(cgh);
+      auto y = y_buffer.template get_access<access::mode::read_write>(cgh);
+      auto tmp = tmp_buffer.template get_access<access::mode::read>(cgh);
 
-      cgh.parallel_for<Atax2>(y_buffer.get_range(), [=, size_ = size](item<1> item) {
+      cgh.parallel_for<Atax2<Backend>>(y_buffer.get_range(), [=, size_ = size](item<1> item) {
         const auto j = item[0];
 
         for(size_t i = 0; i < size_; i++) {
@@ -121,19 +126,17 @@ private:
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> A;
-  std::vector<DATA_TYPE> x;
-  std::vector<DATA_TYPE> y;
-  std::vector<DATA_TYPE> tmp;
-
-  PrefetchedBuffer<DATA_TYPE, 2> A_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> x_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> y_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> tmp_buffer;
+  HostVector<DATA_TYPE> A;
+  HostVector<DATA_TYPE> x;
+  HostVector<DATA_TYPE> y;
+  HostVector<DATA_TYPE> tmp;
+
+  DeviceData<DATA_TYPE, 2, Backend> A_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> x_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> y_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> tmp_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_Atax>();
-  return 0;
+SYCL_BENCH_SUITE(atax, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_Atax<backend>>(); });
 }
@@ -14,10 +14,12 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class Bicg1;
+template <MemoryBackend Backend>
 class Bicg2;
 
-void init_array(DATA_TYPE* A, DATA_TYPE* p, DATA_TYPE* r, size_t size) {
+static void init_array(DATA_TYPE* A, DATA_TYPE* p, DATA_TYPE* r, size_t size) {
   const auto NX = size;
   const auto NY = size;
 
@@ -34,7 +36,7 @@ void init_array(DATA_TYPE* A, DATA_TYPE* p, DATA_TYPE* r, size_t size) {
   }
 }
 
-void bicg_cpu(DATA_TYPE* A, DATA_TYPE* r, DATA_TYPE* s, DATA_TYPE* p, DATA_TYPE* q, size_t size) {
+static void bicg_cpu(DATA_TYPE* A, DATA_TYPE* r, DATA_TYPE* s, DATA_TYPE* p, DATA_TYPE* q, size_t size) {
   const auto NX = size;
   const auto NY = size;
 
@@ -46,8 +48,11 @@ void bicg_cpu(DATA_TYPE* A, DATA_TYPE* r, DATA_TYPE* s, DATA_TYPE* p, DATA_TYPE*
   }
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_Bicg {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_Bicg(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -70,11 +75,11 @@ public:
     using namespace sycl;
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto A = A_buffer.get_access<access::mode::read>(cgh);
-      auto r = r_buffer.get_access<access::mode::read>(cgh);
-      auto s = s_buffer.get_access<access::mode::read_write>(cgh);
+      auto A = A_buffer.template get_access<access::mode::read>(cgh);
+      auto r = r_buffer.template get_access<access::mode::read>(cgh);
+      auto s = s_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<Bicg1>(s_buffer.get_range(), [=, size_ = size](item<1> item) {
+      cgh.parallel_for<Bicg1<Backend>>(s_buffer.get_range(), [=, size_ = size](item<1> item) {
         const auto j = item[0];
 
         for(size_t i = 0; i < size_; i++) {
@@ -84,11 +89,11 @@ public:
     }));
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto A = A_buffer.get_access<access::mode::read>(cgh);
-      auto p = p_buffer.get_access<access::mode::read>(cgh);
-      auto q = q_buffer.get_access<access::mode::read_write>(cgh);
+      auto A = A_buffer.template get_access<access::mode::read>(cgh);
+      auto p = p_buffer.template get_access<access::mode::read>(cgh);
+      auto q = q_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<Bicg2>(q_buffer.get_range(), [=, size_ = size](item<1> item) {
+      cgh.parallel_for<Bicg2<Backend>>(q_buffer.get_range(), [=, size_ = size](item<1> item) {
         const auto i = item[0];
 
         for(size_t j = 0; j < size_; j++) {
@@ -129,21 +134,19 @@ private:
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> A;
-  std::vector<DATA_TYPE> r;
-  std::vector<DATA_TYPE> s;
-  std::vector<DATA_TYPE> p;
-  std::vector<DATA_TYPE> q;
-
-  PrefetchedBuffer<DATA_TYPE, 2> A_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> r_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> s_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> p_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> q_buffer;
+  HostVector<DATA_TYPE> A;
+  HostVector<DATA_TYPE> r;
+  HostVector<DATA_TYPE> s;
+  HostVector<DATA_TYPE> p;
+  HostVector<DATA_TYPE> q;
+
+  DeviceData<DATA_TYPE, 2, Backend> A_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> r_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> s_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> p_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> q_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_Bicg>();
-  return 0;
+SYCL_BENCH_SUITE(bicg, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_Bicg<backend>>(); });
 }
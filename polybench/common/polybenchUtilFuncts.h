@@ -13,7 +13,7 @@
 // define a small float value
 #define SMALL_FLOAT_VAL 0.00000001f
 
-double rtclock() {
+inline double rtclock() {
   struct timezone Tzp;
   struct timeval Tp;
   int stat;
@@ -24,7 +24,7 @@ double rtclock() {
 }
 
 
-float absVal(float a) {
+inline float absVal(float a) {
   if(a < 0) {
     return (a * -1);
   } else {
@@ -33,7 +33,7 @@ float absVal(float a) {
 }
 
 
-float percentDiff(double val1, double val2) {
+inline float percentDiff(double val1, double val2) {
   if((absVal(val1) < 0.01) && (absVal(val2) < 0.01)) {
     return 0.0f;
   } else {
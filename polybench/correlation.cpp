@@ -16,13 +16,18 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class CorrelationMean;
+template <MemoryBackend Backend>
 class CorrelationStd;
+template <MemoryBackend Backend>
 class CorrelationReduce;
+template <MemoryBackend Backend>
 class CorrelationCorr;
+template <MemoryBackend Backend>
 class Correlation5;
 
-void init_arrays(DATA_TYPE* data, size_t size) {
+static void init_arrays(DATA_TYPE* data, size_t size) {
   const auto M = size;
   const auto N = size;
 
@@ -33,7 +38,7 @@ void init_arrays(DATA_TYPE* data, size_t size) {
   }
 }
 
-void correlation(DATA_TYPE* data, DATA_TYPE* mean, DATA_TYPE* stddev, DATA_TYPE* symmat, size_t size) {
+static void correlation(DATA_TYPE* data, DATA_TYPE* mean, DATA_TYPE* stddev, DATA_TYPE* symmat, size_t size) {
   const auto M = size;
   const auto N = size;
 
@@ -88,8 +93,11 @@ void correlation(DATA_TYPE* data, DATA_TYPE* mean, DATA_TYPE* stddev, DATA_TYPE*
   symmat[M * (M + 1) + M] = 1.0;
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_Correlation {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_Correlation(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -110,10 +118,10 @@ public:
     using namespace sycl;
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto data = data_buffer.get_access<access::mode::read>(cgh);
-      auto mean = mean_buffer.get_access<access::mode::read_write>(cgh);
+      auto data = data_buffer.template get_access<access::mode::read>(cgh);
+      auto mean = mean_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<CorrelationMean>(range<1>(size), [=, N_ = size](id<1> gid) {
+      cgh.parallel_for<CorrelationMean<Backend>>(range<1>(size), [=, N_ = size](id<1> gid) {
         const id<1> offset(1);
         const auto j = gid[0] + offset[0];
 
@@ -125,11 +133,11 @@ public:
     }));
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto data = data_buffer.get_access<access::mode::read>(cgh);
-      auto mean = mean_buffer.get_access<access::mode::read>(cgh);
-      auto stddev = stddev_buffer.get_access<access::mode::read_write>(cgh);
+      auto data = data_buffer.template get_access<access::mode::read>(cgh);
+      auto mean = mean_buffer.template get_access<access::mode::read>(cgh);
+      auto stddev = stddev_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<CorrelationStd>(range<1>(size), [=, N_ = size](id<1> gid) {
+      cgh.parallel_for<CorrelationStd<Backend>>(range<1>(size), [=, N_ = size](id<1> gid) {
         const id<1> offset(1);
         const auto adj_id = gid + offset;
         const auto j = gid[0] + offset[0];
@@ -145,11 +153,11 @@ public:
     }));
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto data = data_buffer.get_access<access::mode::read_write>(cgh);
-      auto mean = mean_buffer.get_access<access::mode::read>(cgh);
-      auto stddev = stddev_buffer.get_access<access::mode::read>(cgh);
+      auto data = data_buffer.template get_access<access::mode::read_write>(cgh);
+      auto mean = mean_buffer.template get_access<access::mode::read>(cgh);
+      auto stddev = stddev_buffer.template get_access<access::mode::read>(cgh);
 
-      cgh.parallel_for<CorrelationReduce>(range<2>(size, size), [=](id<2> gid) {
+      cgh.parallel_for<CorrelationReduce<Backend>>(range<2>(size, size), [=](id<2> gid) {
         const id<2> offset(1, 1);
         const auto adj_id = gid + offset;
         const auto j = gid[1] + offset[1];
@@ -161,10 +169,10 @@ public:
     }));
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto data = data_buffer.get_access<access::mode::read>(cgh);
-      auto symmat = symmat_buffer.get_access<access::mode::read_write>(cgh);
+      auto data = data_buffer.template get_access<access::mode::read>(cgh);
+      auto symmat = symmat_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<CorrelationCorr>(range<1>(size), [=, M_ = size, N_ = size](id<1> gid) {
+      cgh.parallel_for<CorrelationCorr<Backend>>(range<1>(size), [=, M_ = size, N_ = size](id<1> gid) {
         // if(item[0] >= M_ - 1) return;
         const id<1> offset(1);
         const auto j1 = gid[0] + offset[0];
@@ -184,8 +192,8 @@ public:
     }));
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto symmat = symmat_buffer.get_access<access::mode::discard_write>(cgh);
-      cgh.parallel_for<Correlation5>(range<2>(1, 1), [=, M_ = size](id<2> gid) {
+      auto symmat = symmat_buffer.template get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<Correlation5<Backend>>(range<2>(1, 1), [=, M_ = size](id<2> gid) {
         const id<2> offset(M_, M_);
         symmat[gid + offset] = 1.0;
       });
@@ -195,17 +203,21 @@ public:
   bool verify(VerificationSetting&) {
     constexpr auto ERROR_THRESHOLD = 0.05;
 
-    std::vector<DATA_TYPE> data_cpu((size + 1) * (size + 1));
-    std::vector<DATA_TYPE> mean_cpu(size + 1);
-    std::vector<DATA_TYPE> stddev_cpu(size + 1);
-    std::vector<DATA_TYPE> symmat_cpu((size + 1) * (size + 1));
+    const auto symmat_cpu =
+        ReferenceCache::get().getOrCompute<DATA_TYPE>(getBenchmarkName(args), size, reference_version, [&]() {
+          std::vector<DATA_TYPE> data_cpu((size + 1) * (size + 1));
+          std::vector<DATA_TYPE> mean_cpu(size + 1);
+          std::vector<DATA_TYPE> stddev_cpu(size + 1);
+          std::vector<DATA_TYPE> symmat_cpu((size + 1) * (size + 1));
+
+          init_arrays(data_cpu.data(), size);
+          correlation(data_cpu.data(), mean_cpu.data(), stddev_cpu.data(), symmat_cpu.data(), size);
+          return symmat_cpu;
+        });
 
     // Trigger writeback
     auto* symmat = symmat_buffer.get_host_access().get_pointer();
 
-    init_arrays(data_cpu.data(), size);
-    correlation(data_cpu.data(), mean_cpu.data(), stddev_cpu.data(), symmat_cpu.data(), size);
-
     for(size_t i = 1; i < size + 1; i++) {
       for(size_t j = 1; j < size + 1; j++) {
         const auto diff = percentDiff(symmat_cpu[i * (size + 1) + j], symmat[i * (size + 1) + j]);
@@ -220,22 +232,22 @@ public:
   static std::string getBenchmarkName(BenchmarkArgs& args) { return "Polybench_Correlation"; }
 
 private:
+  static constexpr unsigned reference_version = 1;
+
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> data;
-  std::vector<DATA_TYPE> mean;
-  std::vector<DATA_TYPE> stddev;
-  std::vector<DATA_TYPE> symmat;
-
-  PrefetchedBuffer<DATA_TYPE, 2> data_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> mean_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> stddev_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> symmat_buffer;
+  HostVector<DATA_TYPE> data;
+  HostVector<DATA_TYPE> mean;
+  HostVector<DATA_TYPE> stddev;
+  HostVector<DATA_TYPE> symmat;
+
+  DeviceData<DATA_TYPE, 2, Backend> data_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> mean_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> stddev_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> symmat_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_Correlation>();
-  return 0;
+SYCL_BENCH_SUITE(correlation, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_Correlation<backend>>(); });
 }
\ No newline at end of file
@@ -11,13 +11,16 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class CovarianceMean;
+template <MemoryBackend Backend>
 class CovarianceReduce;
+template <MemoryBackend Backend>
 class CovarianceCovar;
 
 constexpr DATA_TYPE float_n = 3214212.01;
 
-void init_arrays(DATA_TYPE* data, size_t size) {
+static void init_arrays(DATA_TYPE* data, size_t size) {
   const auto M = size;
   const auto N = size;
 
@@ -28,7 +31,7 @@ void init_arrays(DATA_TYPE* data, size_t size) {
   }
 }
 
-void covariance(DATA_TYPE* data, DATA_TYPE* symmat, DATA_TYPE* mean, size_t size) {
+static void covariance(DATA_TYPE* data, DATA_TYPE* symmat, DATA_TYPE* mean, size_t size) {
   const auto M = size;
   const auto N = size;
 
@@ -60,8 +63,11 @@ void covariance(DATA_TYPE* data, DATA_TYPE* symmat, DATA_TYPE* mean, size_t size
   }
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_Covariance {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_Covariance(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -80,10 +86,10 @@ public:
     using namespace sycl;
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto data = data_buffer.get_access<access::mode::read>(cgh);
-      auto mean = mean_buffer.get_access<access::mode::discard_write>(cgh);
+      auto data = data_buffer.template get_access<access::mode::read>(cgh);
+      auto mean = mean_buffer.template get_access<access::mode::discard_write>(cgh);
 
-      cgh.parallel_for<CovarianceMean>(range<1>(size), [=, N_ = size](id<1> gid) {
+      cgh.parallel_for<CovarianceMean<Backend>>(range<1>(size), [=, N_ = size](id<1> gid) {
         const id<1> offset(1);
         const auto j = gid[0] + offset[0];
 
@@ -96,10 +102,10 @@ public:
     }));
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto mean = mean_buffer.get_access<access::mode::read>(cgh);
-      auto data = data_buffer.get_access<access::mode::read_write>(cgh);
+      auto mean = mean_buffer.template get_access<access::mode::read>(cgh);
+      auto data = data_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<CovarianceReduce>(range<2>(size, size), [=](id<2> gid) {
+      cgh.parallel_for<CovarianceReduce<Backend>>(range<2>(size, size), [=](id<2> gid) {
         const id<2> offset(1, 1);
         const auto j = gid[1] + offset[1];
         data[gid + offset] -= mean[j];
@@ -107,11 +113,11 @@ public:
     }));
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto data = data_buffer.get_access<access::mode::read>(cgh);
-      auto symmat = symmat_buffer.get_access<access::mode::discard_write>(cgh);
-      auto symmat2 = symmat_buffer.get_access<access::mode::discard_write>(cgh);
+      auto data = data_buffer.template get_access<access::mode::read>(cgh);
+      auto symmat = symmat_buffer.template get_access<access::mode::discard_write>(cgh);
+      auto symmat2 = symmat_buffer.template get_access<access::mode::discard_write>(cgh);
 
-      cgh.parallel_for<CovarianceCovar>(range<1>(size), [=, M_ = size, N_ = size](id<1> gid) {
+      cgh.parallel_for<CovarianceCovar<Backend>>(range<1>(size), [=, M_ = size, N_ = size](id<1> gid) {
         const id<1> offset(1);
         const auto j1 = gid[0] + offset[0];
 
@@ -160,17 +166,15 @@ private:
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> data;
-  std::vector<DATA_TYPE> symmat;
-  std::vector<DATA_TYPE> mean;
+  HostVector<DATA_TYPE> data;
+  HostVector<DATA_TYPE> symmat;
+  HostVector<DATA_TYPE> mean;
 
-  PrefetchedBuffer<DATA_TYPE, 2> data_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> symmat_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> mean_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> data_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> symmat_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> mean_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_Covariance>();
-  return 0;
+SYCL_BENCH_SUITE(covariance, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_Covariance<backend>>(); });
 }
\ No newline at end of file
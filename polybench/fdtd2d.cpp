@@ -10,13 +10,16 @@
 
 using DATA_TYPE = double;
 
+template <MemoryBackend Backend>
 class Fdtd2d1;
+template <MemoryBackend Backend>
 class Fdtd2d2;
+template <MemoryBackend Backend>
 class Fdtd2d3;
 
 constexpr auto TMAX = 500;
 
-void init_arrays(DATA_TYPE* fict, DATA_TYPE* ex, DATA_TYPE* ey, DATA_TYPE* hz, size_t size) {
+static void init_arrays(DATA_TYPE* fict, DATA_TYPE* ex, DATA_TYPE* ey, DATA_TYPE* hz, size_t size) {
   const auto NX = size;
   const auto NY = size;
 
@@ -33,7 +36,7 @@ void init_arrays(DATA_TYPE* fict, DATA_TYPE* ex, DATA_TYPE* ey, DATA_TYPE* hz, s
   }
 }
 
-void runFdtd(DATA_TYPE* fict, DATA_TYPE* ex, DATA_TYPE* ey, DATA_TYPE* hz, size_t size) {
+static void runFdtd(DATA_TYPE* fict, DATA_TYPE* ex, DATA_TYPE* ey, DATA_TYPE* hz, size_t size) {
   const auto NX = size;
   const auto NY = size;
 
@@ -63,8 +66,11 @@ void runFdtd(DATA_TYPE* fict, DATA_TYPE* ex, DATA_TYPE* ey, DATA_TYPE* hz, size_
   }
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_Fdtd2d {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_Fdtd2d(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -86,11 +92,11 @@ public:
 
     for(size_t t = 0; t < TMAX; t++) {
       events.push_back(args.device_queue.submit([&](handler& cgh) {
-        auto fict = fict_buffer.get_access<access::mode::read>(cgh);
-        auto ey = ey_buffer.get_access<access::mode::read_write>(cgh);
-        auto hz = hz_buffer.get_access<access::mode::read>(cgh);
+        auto fict = fict_buffer.template get_access<access::mode::read>(cgh);
+        auto ey = ey_buffer.template get_access<access::mode::read_write>(cgh);
+        auto hz = hz_buffer.template get_access<access::mode::read>(cgh);
 
-        cgh.parallel_for<Fdtd2d1>(range<2>(size, size), [=](item<2> item) {
+        cgh.parallel_for<Fdtd2d1<Backend>>(range<2>(size, size), [=](item<2> item) {
           const auto i = item[0];
           const auto j = item[1];
 
@@ -103,10 +109,10 @@ public:
       }));
 
       events.push_back(args.device_queue.submit([&](handler& cgh) {
-        auto ex = ex_buffer.get_access<access::mode::read_write>(cgh);
-        auto hz = hz_buffer.get_access<access::mode::read>(cgh);
+        auto ex = ex_buffer.template get_access<access::mode::read_write>(cgh);
+        auto hz = hz_buffer.template get_access<access::mode::read>(cgh);
 
-        cgh.parallel_for<Fdtd2d2>(range<2>(size, size), [=, NX_ = size, NY_ = size](item<2> item) {
+        cgh.parallel_for<Fdtd2d2<Backend>>(range<2>(size, size), [=, NX_ = size, NY_ = size](item<2> item) {
           const auto i = item[0];
           const auto j = item[1];
 
@@ -116,11 +122,11 @@ public:
       }));
 
       events.push_back(args.device_queue.submit([&](handler& cgh) {
-        auto ex = ex_buffer.get_access<access::mode::read>(cgh);
-        auto ey = ey_buffer.get_access<access::mode::read>(cgh);
-        auto hz = hz_buffer.get_access<access::mode::read_write>(cgh);
+        auto ex = ex_buffer.template get_access<access::mode::read>(cgh);
+        auto ey = ey_buffer.template get_access<access::mode::read>(cgh);
+        auto hz = hz_buffer.template get_access<access::mode::read_write>(cgh);
 
-        cgh.parallel_for<Fdtd2d3>(hz_buffer.get_range(), [=](item<2> item) {
+        cgh.parallel_for<Fdtd2d3<Backend>>(hz_buffer.get_range(), [=](item<2> item) {
           const auto i = item[0];
           const auto j = item[1];
 
@@ -187,22 +193,19 @@ private:
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> fict;
-  std::vector<DATA_TYPE> ex;
-  std::vector<DATA_TYPE> ey;
-  std::vector<DATA_TYPE> hz;
-
-  PrefetchedBuffer<DATA_TYPE, 1> fict_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> ex_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> ey_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> hz_buffer;
+  HostVector<DATA_TYPE> fict;
+  HostVector<DATA_TYPE> ex;
+  HostVector<DATA_TYPE> ey;
+  HostVector<DATA_TYPE> hz;
+
+  DeviceData<DATA_TYPE, 1, Backend> fict_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> ex_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> ey_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> hz_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-
+SYCL_BENCH_SUITE(fdtd2d, "polybench", app) {
   if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
-    app.run<Polybench_Fdtd2d>();
+    app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_Fdtd2d<backend>>(); });
   }
-  return 0;
 }
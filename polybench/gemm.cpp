@@ -13,33 +13,31 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class Gemm;
 
-void init(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, size_t size) {
+static void init(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, size_t size) {
   const auto NI = size;
   const auto NJ = size;
   const auto NK = size;
 
-  for(size_t i = 0; i < NI; i++) {
-    for(size_t j = 0; j < NK; j++) {
-      A[i * NK + j] = ((DATA_TYPE)i * j) / NI;
-    }
-  }
+  generateInput(A, NI * NK, [=](size_t idx) {
+    const auto i = idx / NK, j = idx % NK;
+    return ((DATA_TYPE)i * j) / NI;
+  });
 
-  for(size_t i = 0; i < NK; i++) {
-    for(size_t j = 0; j < NJ; j++) {
-      B[i * NJ + j] = ((DATA_TYPE)i * j + 1) / NJ;
-    }
-  }
+  generateInput(B, NK * NJ, [=](size_t idx) {
+    const auto i = idx / NJ, j = idx % NJ;
+    return ((DATA_TYPE)i * j + 1) / NJ;
+  });
 
-  for(size_t i = 0; i < NI; i++) {
-    for(size_t j = 0; j < NJ; j++) {
-      C[i * NJ + j] = ((DATA_TYPE)i * j + 2) / NJ;
-    }
-  }
+  generateInput(C, NI * NJ, [=](size_t idx) {
+    const auto i = idx / NJ, j = idx % NJ;
+    return ((DATA_TYPE)i * j + 2) / NJ;
+  });
 }
 
-void gemm(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, size_t size) {
+static void gemm(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, size_t size) {
   const auto NI = size;
   const auto NJ = size;
   const auto NK = size;
@@ -55,8 +53,11 @@ void gemm(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, size_t size) {
   }
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_Gemm {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_Gemm(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -75,11 +76,11 @@ public:
     using namespace sycl;
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto A = A_buffer.get_access<access::mode::read>(cgh);
-      auto B = B_buffer.get_access<access::mode::read>(cgh);
-      auto C = C_buffer.get_access<access::mode::read_write>(cgh);
+      auto A = A_buffer.template get_access<access::mode::read>(cgh);
+      auto B = B_buffer.template get_access<access::mode::read>(cgh);
+      auto C = C_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<Gemm>(C_buffer.get_range(), [=, NK_ = size](item<2> item) {
+      cgh.parallel_for<Gemm<Backend>>(C_buffer.get_range(), [=, NK_ = size](item<2> item) {
         const auto i = item[0];
         const auto j = item[1];
 
@@ -92,17 +93,45 @@ public:
     }));
   }
 
+  // Parallel CPU implementation of run(), updating a copy of C
+  void runNative() {
+    if(C_native.empty())
+      C_native.assign(C.begin(), C.end());
+
+    NativeThreadPool::get().parallelFor(size, [&](size_t begin, size_t end) {
+      for(size_t i = begin; i < end; i++) {
+        DATA_TYPE* c = &C_native[i * size];
+        for(size_t j = 0; j < size; j++) c[j] *= BETA;
+
+        for(size_t k = 0; k < size; k++) {
+          const DATA_TYPE a = ALPHA * A[i * size + k];
+          const DATA_TYPE* b = &B[k * size];
+          for(size_t j = 0; j < size; j++) c[j] += a * b[j];
+        }
+      }
+    });
+  }
+
+  void reset() {
+    // C is updated in-place by run(), restore its initial values
+    C_buffer.initialize(args.device_queue, C.data(), sycl::range<2>(size, size));
+  }
+
   bool verify(VerificationSetting&) {
     constexpr auto ERROR_THRESHOLD = 0.05;
 
     // Trigger writeback
     auto* C = C_buffer.get_host_access().get_pointer();
 
-    std::vector<DATA_TYPE> C_cpu(size * size);
+    const auto C_cpu =
+        ReferenceCache::get().getOrCompute<DATA_TYPE>(getBenchmarkName(args), size, reference_version, [&]() {
+          std::vector<DATA_TYPE> C_cpu(size * size);
 
-    init(A.data(), B.data(), C_cpu.data(), size);
+          init(A.data(), B.data(), C_cpu.data(), size);
 
-    gemm(A.data(), B.data(), C_cpu.data(), size);
+          gemm(A.data(), B.data(), C_cpu.data(), size);
+          return C_cpu;
+        });
 
     for(size_t i = 0; i < size; i++) {
       for(size_t j = 0; j < size; j++) {
@@ -115,23 +144,35 @@ public:
     return true;
   }
 
+  // Compulsory traffic only: A and B are read once, C is read and written once
+  static double getBytesMoved(const BenchmarkArgs& args) {
+    return 4.0 * args.problem_size * args.problem_size * sizeof(DATA_TYPE);
+  }
+
+  // One multiplication for beta, and a multiplication by alpha plus an FMA per k
+  static double getFlops(const BenchmarkArgs& args) {
+    const double n = static_cast<double>(args.problem_size);
+    return n * n * (1.0 + 3.0 * n);
+  }
+
   static std::string getBenchmarkName(BenchmarkArgs& args) { return "Polybench_Gemm"; }
 
 private:
+  static constexpr unsigned reference_version = 1;
+
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> A;
-  std::vector<DATA_TYPE> B;
-  std::vector<DATA_TYPE> C;
-
-  PrefetchedBuffer<DATA_TYPE, 2> A_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> B_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> C_buffer;
+  HostVector<DATA_TYPE> A;
+  HostVector<DATA_TYPE> B;
+  HostVector<DATA_TYPE> C;
+  HostVector<DATA_TYPE> C_native;
+
+  DeviceData<DATA_TYPE, 2, Backend> A_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> B_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> C_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_Gemm>();
-  return 0;
+SYCL_BENCH_SUITE(gemm, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_Gemm<backend>>(); });
 }
@@ -10,6 +10,7 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class Gesummv;
 
 constexpr DATA_TYPE ALPHA = 1;
@@ -27,7 +28,7 @@ constexpr DATA_TYPE BETA = 1;
 // PERCENT_DIFF_ERROR_THRESHOLD, fail);
 // }
 
-void init(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* x, size_t size) {
+static void init(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* x, size_t size) {
   const auto N = size;
 
   for(size_t i = 0; i < N; i++) {
@@ -40,7 +41,7 @@ void init(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* x, size_t size) {
   }
 }
 
-void gesummv(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* x, DATA_TYPE* y, DATA_TYPE* tmp, size_t size) {
+static void gesummv(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* x, DATA_TYPE* y, DATA_TYPE* tmp, size_t size) {
   const auto N = size;
 
   for(size_t i = 0; i < N; i++) {
@@ -55,8 +56,11 @@ void gesummv(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* x, DATA_TYPE* y, DATA_TYPE*
   }
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_Gesummv {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_Gesummv(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -79,13 +83,13 @@ public:
     using namespace sycl;
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto A = A_buffer.get_access<access::mode::read>(cgh);
-      auto B = B_buffer.get_access<access::mode::read>(cgh);
-      auto x = x_buffer.get_access<access::mode::read>(cgh);
-      auto y = y_buffer.get_access<access::mode::read_write>(cgh);
-      auto tmp = tmp_buffer.get_access<access::mode::read_write>(cgh);
+      auto A = A_buffer.template get_access<access::mode::read>(cgh);
+      auto B = B_buffer.template get_access<access::mode::read>(cgh);
+      auto x = x_buffer.template get_access<access::mode::read>(cgh);
+      auto y = y_buffer.template get_access<access::mode::read_write>(cgh);
+      auto tmp = tmp_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<Gesummv>(y.get_range(), [=, N_ = size](item<1> item) {
+      cgh.parallel_for<Gesummv<Backend>>(y.get_range(), [=, N_ = size](item<1> item) {
         const auto i = item[0];
 
         for(size_t j = 0; j < N_; j++) {
@@ -124,21 +128,19 @@ private:
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> A;
-  std::vector<DATA_TYPE> B;
-  std::vector<DATA_TYPE> x;
-  std::vector<DATA_TYPE> y;
-  std::vector<DATA_TYPE> tmp;
-
-  PrefetchedBuffer<DATA_TYPE, 2> A_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> B_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> x_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> y_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> tmp_buffer;
+  HostVector<DATA_TYPE> A;
+  HostVector<DATA_TYPE> B;
+  HostVector<DATA_TYPE> x;
+  HostVector<DATA_TYPE> y;
+  HostVector<DATA_TYPE> tmp;
+
+  DeviceData<DATA_TYPE, 2, Backend> A_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> B_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> x_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> y_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> tmp_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_Gesummv>();
-  return 0;
+SYCL_BENCH_SUITE(gesummv, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_Gesummv<backend>>(); });
 }
@@ -11,11 +11,14 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class Gramschmidt1;
+template <MemoryBackend Backend>
 class Gramschmidt2;
+template <MemoryBackend Backend>
 class Gramschmidt3;
 
-void init_array(DATA_TYPE* A, size_t size) {
+static void init_array(DATA_TYPE* A, size_t size) {
   const auto M = size;
   const auto N = size;
 
@@ -26,7 +29,7 @@ void init_array(DATA_TYPE* A, size_t size) {
   }
 }
 
-void gramschmidt(DATA_TYPE* A, DATA_TYPE* R, DATA_TYPE* Q, size_t size) {
+static void gramschmidt(DATA_TYPE* A, DATA_TYPE* R, DATA_TYPE* Q, size_t size) {
   const auto M = size;
   const auto N = size;
 
@@ -53,8 +56,11 @@ void gramschmidt(DATA_TYPE* A, DATA_TYPE* R, DATA_TYPE* Q, size_t size) {
   }
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_Gramschmidt {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_Gramschmidt(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -74,10 +80,10 @@ public:
 
     for(size_t k = 0; k < size; k++) {
       events.push_back(args.device_queue.submit([&](handler& cgh) {
-        auto A = A_buffer.get_access<access::mode::read>(cgh);
-        auto R = R_buffer.get_access<access::mode::write>(cgh);
+        auto A = A_buffer.template get_access<access::mode::read>(cgh);
+        auto R = R_buffer.template get_access<access::mode::write>(cgh);
 
-        cgh.parallel_for<Gramschmidt1>(range<2>(1, 1), [=, M_ = size](item<2> item) {
+        cgh.parallel_for<Gramschmidt1<Backend>>(range<2>(1, 1), [=, M_ = size](item<2> item) {
           DATA_TYPE nrm = 0;
           for(size_t i = 0; i < M_; i++) {
             nrm += A[{i, k}] * A[{i, k}];
@@ -87,22 +93,22 @@ public:
       }));
 
       events.push_back(args.device_queue.submit([&](handler& cgh) {
-        auto A = A_buffer.get_access<access::mode::read>(cgh);
-        auto R = R_buffer.get_access<access::mode::read>(cgh);
-        auto Q = Q_buffer.get_access<access::mode::write>(cgh);
+        auto A = A_buffer.template get_access<access::mode::read>(cgh);
+        auto R = R_buffer.template get_access<access::mode::read>(cgh);
+        auto Q = Q_buffer.template get_access<access::mode::write>(cgh);
 
-        cgh.parallel_for<Gramschmidt2>(range<2>(size, 1), [=](item<2> gid) {
+        cgh.parallel_for<Gramschmidt2<Backend>>(range<2>(size, 1), [=](item<2> gid) {
           const id<2> offset(0, k);
           Q[gid + offset] = A[gid + offset] / R[{k, k}];
         });
       }));
 
       events.push_back(args.device_queue.submit([&](handler& cgh) {
-        auto A = A_buffer.get_access<access::mode::read_write>(cgh);
-        auto R = R_buffer.get_access<access::mode::write>(cgh);
-        auto Q = Q_buffer.get_access<access::mode::read>(cgh);
+        auto A = A_buffer.template get_access<access::mode::read_write>(cgh);
+        auto R = R_buffer.template get_access<access::mode::write>(cgh);
+        auto Q = Q_buffer.template get_access<access::mode::read>(cgh);
 
-        cgh.parallel_for<Gramschmidt3>(range<2>(size, 1), [=, M_ = size, N_ = size](item<2> item) {
+        cgh.parallel_for<Gramschmidt3<Backend>>(range<2>(size, 1), [=, M_ = size, N_ = size](item<2> item) {
           const auto j = item[0];
 
           if(j <= k || j >= N_)
@@ -152,17 +158,15 @@ private:
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> A;
-  std::vector<DATA_TYPE> R;
-  std::vector<DATA_TYPE> Q;
+  HostVector<DATA_TYPE> A;
+  HostVector<DATA_TYPE> R;
+  HostVector<DATA_TYPE> Q;
 
-  PrefetchedBuffer<DATA_TYPE, 2> A_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> R_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> Q_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> A_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> R_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> Q_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_Gramschmidt>();
-  return 0;
+SYCL_BENCH_SUITE(gramschmidt, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_Gramschmidt<backend>>(); });
 }
\ No newline at end of file
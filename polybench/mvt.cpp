@@ -10,10 +10,12 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class Mvt1;
+template <MemoryBackend Backend>
 class Mvt2;
 
-void init_arrays(DATA_TYPE* a, DATA_TYPE* x1, DATA_TYPE* x2, DATA_TYPE* y_1, DATA_TYPE* y_2, size_t size) {
+static void init_arrays(DATA_TYPE* a, DATA_TYPE* x1, DATA_TYPE* x2, DATA_TYPE* y_1, DATA_TYPE* y_2, size_t size) {
   const auto N = size;
 
   for(size_t i = 0; i < N; i++) {
@@ -28,7 +30,7 @@ void init_arrays(DATA_TYPE* a, DATA_TYPE* x1, DATA_TYPE* x2, DATA_TYPE* y_1, DAT
   }
 }
 
-void runMvt(DATA_TYPE* a, DATA_TYPE* x1, DATA_TYPE* x2, DATA_TYPE* y1, DATA_TYPE* y2, size_t size) {
+static void runMvt(DATA_TYPE* a, DATA_TYPE* x1, DATA_TYPE* x2, DATA_TYPE* y1, DATA_TYPE* y2, size_t size) {
   const auto N = size;
 
   for(size_t i = 0; i < N; i++) {
@@ -44,8 +46,11 @@ void runMvt(DATA_TYPE* a, DATA_TYPE* x1, DATA_TYPE* x2, DATA_TYPE* y1, DATA_TYPE
   }
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_Mvt {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_Mvt(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -68,11 +73,11 @@ public:
     using namespace sycl;
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto a = a_buffer.get_access<access::mode::read>(cgh);
-      auto y1 = y1_buffer.get_access<access::mode::read>(cgh);
-      auto x1 = x1_buffer.get_access<access::mode::read_write>(cgh);
+      auto a = a_buffer.template get_access<access::mode::read>(cgh);
+      auto y1 = y1_buffer.template get_access<access::mode::read>(cgh);
+      auto x1 = x1_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<Mvt1>(x1_buffer.get_range(), [=, N_ = size](item<1> item) {
+      cgh.parallel_for<Mvt1<Backend>>(x1_buffer.get_range(), [=, N_ = size](item<1> item) {
         const auto i = item[0];
 
         for(size_t j = 0; j < N_; j++) {
@@ -82,11 +87,11 @@ public:
     }));
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto a = a_buffer.get_access<access::mode::read>(cgh);
-      auto y2 = y2_buffer.get_access<access::mode::read>(cgh);
-      auto x2 = x2_buffer.get_access<access::mode::read_write>(cgh);
+      auto a = a_buffer.template get_access<access::mode::read>(cgh);
+      auto y2 = y2_buffer.template get_access<access::mode::read>(cgh);
+      auto x2 = x2_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<Mvt2>(x1_buffer.get_range(), [=, N_ = size](item<1> item) {
+      cgh.parallel_for<Mvt2<Backend>>(x1_buffer.get_range(), [=, N_ = size](item<1> item) {
         const auto k = item[0];
 
         for(size_t l = 0; l < N_; l++) {
@@ -129,21 +134,19 @@ private:
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> a;
-  std::vector<DATA_TYPE> x1;
-  std::vector<DATA_TYPE> x2;
-  std::vector<DATA_TYPE> y1;
-  std::vector<DATA_TYPE> y2;
-
-  PrefetchedBuffer<DATA_TYPE, 2> a_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> x1_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> x2_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> y1_buffer;
-  PrefetchedBuffer<DATA_TYPE, 1> y2_buffer;
+  HostVector<DATA_TYPE> a;
+  HostVector<DATA_TYPE> x1;
+  HostVector<DATA_TYPE> x2;
+  HostVector<DATA_TYPE> y1;
+  HostVector<DATA_TYPE> y2;
+
+  DeviceData<DATA_TYPE, 2, Backend> a_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> x1_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> x2_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> y1_buffer;
+  DeviceData<DATA_TYPE, 1, Backend> y2_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_Mvt>();
-  return 0;
+SYCL_BENCH_SUITE(mvt, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_Mvt<backend>>(); });
 }
@@ -10,28 +10,33 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class Syr2k1;
 
 constexpr DATA_TYPE ALPHA = 1;
 constexpr DATA_TYPE BETA = 1;
 
-void init_arrays(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, size_t size) {
+static void init_arrays(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, size_t size) {
   const auto N = size;
   const auto M = size;
 
-  for(size_t i = 0; i < N; i++) {
-    for(size_t j = 0; j < N; j++) {
-      C[i * N + j] = ((DATA_TYPE)i * j + 2) / N;
-    }
+  generateInput(C, N * N, [=](size_t idx) {
+    const auto i = idx / N, j = idx % N;
+    return ((DATA_TYPE)i * j + 2) / N;
+  });
 
-    for(size_t j = 0; j < M; j++) {
-      A[i * N + j] = ((DATA_TYPE)i * j) / N;
-      B[i * N + j] = ((DATA_TYPE)i * j + 1) / N;
-    }
-  }
+  generateInput(A, N * M, [=](size_t idx) {
+    const auto i = idx / M, j = idx % M;
+    return ((DATA_TYPE)i * j) / N;
+  });
+
+  generateInput(B, N * M, [=](size_t idx) {
+    const auto i = idx / M, j = idx % M;
+    return ((DATA_TYPE)i * j + 1) / N;
+  });
 }
 
-void syr2k(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, size_t size) {
+static void syr2k(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, size_t size) {
   const auto N = size;
   const auto M = size;
 
@@ -51,8 +56,11 @@ void syr2k(DATA_TYPE* A, DATA_TYPE* B, DATA_TYPE* C, size_t size) {
   }
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_Syr2k {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_Syr2k(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -71,11 +79,11 @@ public:
     using namespace sycl;
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto A = A_buffer.get_access<access::mode::read>(cgh);
-      auto B = B_buffer.get_access<access::mode::read>(cgh);
-      auto C = C_buffer.get_access<access::mode::read_write>(cgh);
+      auto A = A_buffer.template get_access<access::mode::read>(cgh);
+      auto B = B_buffer.template get_access<access::mode::read>(cgh);
+      auto C = C_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<Syr2k1>(C_buffer.get_range(), [=, M_ = size](item<2> item) {
+      cgh.parallel_for<Syr2k1<Backend>>(C_buffer.get_range(), [=, M_ = size](item<2> item) {
         const auto i = item[0];
         const auto j = item[1];
 
@@ -88,18 +96,47 @@ public:
     }));
   }
 
+  // Parallel CPU implementation of run(), updating a copy of C
+  void runNative() {
+    if(C_native.empty())
+      C_native.assign(C.begin(), C.end());
+
+    NativeThreadPool::get().parallelFor(size, [&](size_t begin, size_t end) {
+      for(size_t i = begin; i < end; i++) {
+        for(size_t j = 0; j < size; j++) {
+          const DATA_TYPE* a_i = &A[i * size];
+          const DATA_TYPE* b_i = &B[i * size];
+          const DATA_TYPE* a_j = &A[j * size];
+          const DATA_TYPE* b_j = &B[j * size];
+          DATA_TYPE sum = 0;
+          for(size_t k = 0; k < size; k++) sum += ALPHA * a_i[k] * b_j[k] + ALPHA * b_i[k] * a_j[k];
+          C_native[i * size + j] = C_native[i * size + j] * BETA + sum;
+        }
+      }
+    });
+  }
+
+  void reset() {
+    // C is updated in-place by run(), restore its initial values
+    init_arrays(A.data(), B.data(), C.data(), size);
+    C_buffer.initialize(args.device_queue, C.data(), sycl::range<2>(size, size));
+  }
+
   bool verify(VerificationSetting&) {
     constexpr auto ERROR_THRESHOLD = 0.05;
 
-    std::vector<DATA_TYPE> C_cpu(size * size);
+    const auto C_cpu =
+        ReferenceCache::get().getOrCompute<DATA_TYPE>(getBenchmarkName(args), size, reference_version, [&]() {
+          std::vector<DATA_TYPE> C_cpu(size * size);
 
-    init_arrays(A.data(), B.data(), C_cpu.data(), size);
+          init_arrays(A.data(), B.data(), C_cpu.data(), size);
+          syr2k(A.data(), B.data(), C_cpu.data(), size);
+          return C_cpu;
+        });
 
     // Trigger writeback
     auto* C = C_buffer.get_host_access().get_pointer();
 
-    syr2k(A.data(), B.data(), C_cpu.data(), size);
-
     for(size_t i = 0; i < size; i++) {
       for(size_t j = 0; j < size; j++) {
         const auto diff = percentDiff(C_cpu[i * size + j], C[i * size + j]);
@@ -114,20 +151,21 @@ public:
   static std::string getBenchmarkName(BenchmarkArgs& args) { return "Polybench_Syr2k"; }
 
 private:
+  static constexpr unsigned reference_version = 1;
+
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> A;
-  std::vector<DATA_TYPE> B;
-  std::vector<DATA_TYPE> C;
-
-  PrefetchedBuffer<DATA_TYPE, 2> A_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> B_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> C_buffer;
+  HostVector<DATA_TYPE> A;
+  HostVector<DATA_TYPE> B;
+  HostVector<DATA_TYPE> C;
+  HostVector<DATA_TYPE> C_native;
+
+  DeviceData<DATA_TYPE, 2, Backend> A_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> B_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> C_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_Syr2k>();
-  return 0;
+SYCL_BENCH_SUITE(syr2k, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_Syr2k<backend>>(); });
 }
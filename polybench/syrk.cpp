@@ -10,12 +10,13 @@
 
 using DATA_TYPE = float;
 
+template <MemoryBackend Backend>
 class Syr2k2;
 
 constexpr DATA_TYPE alpha = 123;
 constexpr DATA_TYPE beta = 14512;
 
-void init_arrays(DATA_TYPE* A, DATA_TYPE* C, size_t size) {
+static void init_arrays(DATA_TYPE* A, DATA_TYPE* C, size_t size) {
   const auto N = size;
   const auto M = size;
 
@@ -30,7 +31,7 @@ void init_arrays(DATA_TYPE* A, DATA_TYPE* C, size_t size) {
   }
 }
 
-void syrk(DATA_TYPE* A, DATA_TYPE* C, size_t size) {
+static void syrk(DATA_TYPE* A, DATA_TYPE* C, size_t size) {
   const auto N = size;
   const auto M = size;
 
@@ -50,8 +51,11 @@ void syrk(DATA_TYPE* A, DATA_TYPE* C, size_t size) {
   }
 }
 
+template <MemoryBackend Backend = MemoryBackend::buffer>
 class Polybench_Syrk {
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   Polybench_Syrk(const BenchmarkArgs& args) : args(args), size(args.problem_size) {}
 
   void setup() {
@@ -68,10 +72,10 @@ public:
     using namespace sycl;
 
     events.push_back(args.device_queue.submit([&](handler& cgh) {
-      auto A = A_buffer.get_access<access::mode::read>(cgh);
-      auto C = C_buffer.get_access<access::mode::read_write>(cgh);
+      auto A = A_buffer.template get_access<access::mode::read>(cgh);
+      auto C = C_buffer.template get_access<access::mode::read_write>(cgh);
 
-      cgh.parallel_for<Syr2k2>(C_buffer.get_range(), [=, M_ = size](item<2> item) {
+      cgh.parallel_for<Syr2k2<Backend>>(C_buffer.get_range(), [=, M_ = size](item<2> item) {
         const auto i = item[0];
         const auto j = item[1];
 
@@ -84,6 +88,12 @@ public:
     }));
   }
 
+  void reset() {
+    // C is updated in-place by run(), restore its initial values
+    init_arrays(A.data(), C.data(), size);
+    C_buffer.initialize(args.device_queue, C.data(), sycl::range<2>(size, size));
+  }
+
   bool verify(VerificationSetting&) {
     constexpr auto ERROR_THRESHOLD = 0.05;
 
@@ -113,15 +123,13 @@ private:
   BenchmarkArgs args;
 
   const size_t size;
-  std::vector<DATA_TYPE> A;
-  std::vector<DATA_TYPE> C;
+  HostVector<DATA_TYPE> A;
+  HostVector<DATA_TYPE> C;
 
-  PrefetchedBuffer<DATA_TYPE, 2> A_buffer;
-  PrefetchedBuffer<DATA_TYPE, 2> C_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> A_buffer;
+  DeviceData<DATA_TYPE, 2, Backend> C_buffer;
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<Polybench_Syrk>();
-  return 0;
+SYCL_BENCH_SUITE(syrk, "polybench", app) {
+  app.forEachMemoryBackend([&](auto backend) { app.run<Polybench_Syrk<backend>>(); });
 }
@@ -111,8 +111,108 @@ private:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+template <int Num_iterations>
+class MandelbrotStreamingKernel;
+
+/// Out-of-core variant of BlockedTransform (--streaming): instead of relying on
+/// ranged accessors, blocks are explicitly streamed through the device as tiles of
+/// a StreamingPipeline. The data stays in pinned host memory and the results are
+/// written to a second host array, so the problem size is only limited by host
+/// memory.
+template <int Num_iterations>
+class BlockedTransformStreaming {
+private:
+  BenchmarkArgs args;
+  USMBuffer<complex, 1, sycl::usm::alloc::host> input;
+  USMBuffer<complex, 1, sycl::usm::alloc::host> output;
+  StreamingPipeline pipeline;
+  // Every slot holds one tile, which is transformed in place
+  complex* device_tiles = nullptr;
+
+  complex* getTile(const StreamingTile& tile) const { return device_tiles + tile.slot * pipeline.getTileElements(); }
+
+  complex getInput(std::size_t i) const {
+    return complex{static_cast<float>(0.8 * std::cos(i / args.problem_size)),
+        static_cast<float>(0.8 * std::sin(i / args.problem_size))};
+  }
+
+public:
+  BlockedTransformStreaming(const BenchmarkArgs& _args) : args(_args), pipeline{_args.problem_size, sizeof(complex)} {}
+
+  ~BlockedTransformStreaming() {
+    if(device_tiles != nullptr)
+      sycl::free(device_tiles, args.device_queue);
+  }
+
+  void setup() {
+    input.initialize(args.device_queue, args.problem_size);
+    output.initialize(args.device_queue, args.problem_size);
+    generateInput(input.get(), args.problem_size, [this](std::size_t i) { return getInput(i); });
+    device_tiles = sycl::malloc_device<complex>(pipeline.getTileElements() * pipeline.getDepth(), args.device_queue);
+
+    pipeline.setStages(
+        [this](const StreamingTile& tile, const sycl::event& dependency) {
+          return args.device_queue.memcpy(
+              getTile(tile), input.get() + tile.offset, tile.count * sizeof(complex), dependency);
+        },
+        [this](const StreamingTile& tile, const sycl::event& dependency) {
+          return args.device_queue.submit([&](sycl::handler& cgh) {
+            cgh.depends_on(dependency);
+            complex* data = getTile(tile);
+            cgh.parallel_for<MandelbrotStreamingKernel<Num_iterations>>(
+                sycl::range<1>{tile.count}, [=](sycl::id<1> idx) {
+                  const complex z0{0.0f, 0.0f};
+                  data[idx] = mandelbrot_sequence<Num_iterations>(z0, data[idx]);
+                });
+          });
+        },
+        [this](const StreamingTile& tile, const sycl::event& dependency) {
+          return args.device_queue.memcpy(
+              output.get() + tile.offset, getTile(tile), tile.count * sizeof(complex), dependency);
+        });
+    pipeline.calibrate();
+  }
+
+  void run() { pipeline.run(); }
+
+  bool verify(VerificationSetting& ver) {
+    const double tol = 1.e-5;
+
+    for(std::size_t i = 0; i < args.problem_size; ++i) {
+      const complex expected = mandelbrot_sequence<Num_iterations>(complex{0.0f, 0.0f}, getInput(i));
+
+      if(std::abs(expected.x() - output.get()[i].x()) > tol)
+        return false;
+      if(std::abs(expected.y() - output.get()[i].y()) > tol)
+        return false;
+    }
+
+    return true;
+  }
+
+  // End-to-end throughput in bytes copied between host and device
+  static ThroughputMetric getThroughputMetric(const BenchmarkArgs& args) {
+    return {2.0 * args.problem_size * sizeof(complex) / 1024.0 / 1024.0 / 1024.0, "GiB"};
+  }
+
+  static constexpr bool idempotent = true;
+
+  std::string getBenchmarkName(BenchmarkArgs& args) {
+    std::stringstream name;
+    name << "Runtime_BlockedTransform_Streaming_iter_";
+    name << Num_iterations;
+    return name.str();
+  }
+};
+
+SYCL_BENCH_SUITE(blocked_transform, "runtime", app) {
+  if(app.shouldRunStreaming()) {
+    app.run<BlockedTransformStreaming<64>>();
+    app.run<BlockedTransformStreaming<128>>();
+    app.run<BlockedTransformStreaming<256>>();
+    app.run<BlockedTransformStreaming<512>>();
+    return;
+  }
 
   for(std::size_t block_size = app.getArgs().local_size; block_size < app.getArgs().problem_size; block_size *= 2) {
     app.run<BlockedTransform<64>>(block_size);
@@ -120,6 +220,4 @@ int main(int argc, char** argv) {
     app.run<BlockedTransform<256>>(block_size);
     app.run<BlockedTransform<512>>(block_size);
   }
-
-  return 0;
 }
@@ -6,8 +6,8 @@ using namespace sycl;
 
 class IndependentDagTaskThroughputKernelSingleTask;
 class IndependentDagTaskThroughputKernelBasicPF;
-class DagTaskThroughputKernelNdrangePF;
-class DagTaskThroughputKernelHierarchicalPF;
+class IndependentDagTaskThroughputKernelNdrangePF;
+class IndependentDagTaskThroughputKernelHierarchicalPF;
 
 // Measures the time it takes to run <problem-size> trivial single_task and parallel_for kernels
 // that are *independent*.
@@ -20,6 +20,9 @@ class IndependentDagTaskThroughput {
 public:
   IndependentDagTaskThroughput(const BenchmarkArgs& _args) : args(_args) {}
 
+  // Runs only overwrite the dummy buffers, so they can be repeated as inner iterations
+  static constexpr bool idempotent = true;
+
   void setup() {
     for(std::size_t i = 0; i < args.problem_size; ++i) {
       dummy_buffers.push_back(sycl::buffer<int, 1>{sycl::range<1>{1}});
@@ -57,7 +60,7 @@ public:
       args.device_queue.submit([&](sycl::handler& cgh) {
         auto acc = dummy_buffers[i].get_access<sycl::access::mode::discard_write>(cgh);
 
-        cgh.parallel_for<DagTaskThroughputKernelNdrangePF>(
+        cgh.parallel_for<IndependentDagTaskThroughputKernelNdrangePF>(
             sycl::nd_range<1>{sycl::range<1>{args.local_size}, sycl::range<1>{args.local_size}},
             [=](sycl::nd_item<1> idx) {
               if(idx.get_global_id(0) == 0)
@@ -72,7 +75,7 @@ public:
       args.device_queue.submit([&](sycl::handler& cgh) {
         auto acc = dummy_buffers[i].get_access<sycl::access::mode::discard_write>(cgh);
 
-        cgh.parallel_for_work_group<DagTaskThroughputKernelHierarchicalPF>(
+        cgh.parallel_for_work_group<IndependentDagTaskThroughputKernelHierarchicalPF>(
             sycl::range<1>{1}, sycl::range<1>{args.local_size}, [=](sycl::group<1> grp) {
               grp.parallel_for_work_item([&](sycl::h_item<1> idx) {
                 if(idx.get_global_id(0) == 0)
@@ -137,9 +140,7 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-
+SYCL_BENCH_SUITE(dag_task_throughput_independent, "runtime", app) {
   app.run<IndependentDagTaskThroughputSingleTask>();
   app.run<IndependentDagTaskThroughputBasicPF>();
   app.run<IndependentDagTaskThroughputHierarchicalPF>();
@@ -147,6 +148,4 @@ int main(int argc, char** argv) {
   // or triSYCL, this will be prohibitively slow
   if(app.shouldRunNDRangeKernels())
     app.run<IndependentDagTaskThroughputNDRangePF>();
-
-  return 0;
 }
@@ -132,9 +132,7 @@ public:
 };
 
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-
+SYCL_BENCH_SUITE(dag_task_throughput_sequential, "runtime", app) {
   app.run<DagTaskThroughputSingleTask>();
   app.run<DagTaskThroughputBasicPF>();
   app.run<DagTaskThroughputHierarchicalPF>();
@@ -142,6 +140,4 @@ int main(int argc, char** argv) {
   // or triSYCL, this will be prohibitively slow
   if(app.shouldRunNDRangeKernels())
     app.run<DagTaskThroughputNDRangePF>();
-
-  return 0;
 }
@@ -84,6 +84,8 @@ public:
     multiply(args.device_queue, mat_p_buf.get(), mat_q_buf.get(), mat_res_buf.get(), mat_size);
   }
 
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) { return "MatmulChain"; }
 
   bool verify(VerificationSetting& ver) {
@@ -109,9 +111,7 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-
+SYCL_BENCH_SUITE(matmulchain, "runtime", app) {
   // float
   app.run<MatmulChain<float>>();
 }
@@ -10,12 +10,24 @@ namespace s = sycl;
 template <typename T>
 class KmeansKernel;
 
+// Initial values of the features and cluster centers, usable as generators of PrefetchedBuffer::initialize.
+// Small integers keep the distances exact, so that the device and the host agree on the nearest cluster.
+template <typename T>
+struct KmeansFeatures {
+  T operator()(size_t i) const { return static_cast<T>(i % 251); }
+};
+
+template <typename T>
+struct KmeansClusters {
+  T operator()(size_t i) const { return static_cast<T>(i % 13); }
+};
+
+// With --no-host-mirror, the inputs are generated on the device and only samples of the membership are verified
 template <typename T>
 class KmeansBench {
 protected:
   std::vector<T> features;
   std::vector<T> clusters;
-  std::vector<int> membership;
   int nfeatures;
   int nclusters;
   int feature_size;
@@ -38,13 +50,19 @@ public:
     feature_size = nfeatures * args.problem_size;
     cluster_size = nclusters * args.problem_size;
 
-    features.resize(feature_size, 2.0f);
-    clusters.resize(cluster_size, 1.0f);
-    membership.resize(args.problem_size, 0);
-
-    features_buf.initialize(args.device_queue, features.data(), s::range<1>(feature_size));
-    clusters_buf.initialize(args.device_queue, clusters.data(), s::range<1>(cluster_size));
-    membership_buf.initialize(args.device_queue, membership.data(), s::range<1>(args.problem_size));
+    if(DeviceInit::isEnabled()) {
+      features_buf.initialize(args.device_queue, s::range<1>(feature_size), KmeansFeatures<T>{});
+      clusters_buf.initialize(args.device_queue, s::range<1>(cluster_size), KmeansClusters<T>{});
+    } else {
+      features.resize(feature_size);
+      clusters.resize(cluster_size);
+      generateInput(features.data(), features.size(), KmeansFeatures<T>{});
+      generateInput(clusters.data(), clusters.size(), KmeansClusters<T>{});
+      features_buf.initialize(args.device_queue, features.data(), s::range<1>(feature_size));
+      clusters_buf.initialize(args.device_queue, clusters.data(), s::range<1>(cluster_size));
+    }
+    // The membership is overwritten by every run and does not need initial values
+    membership_buf.initialize(args.device_queue, s::range<1>(args.problem_size));
   }
 
   void run(std::vector<sycl::event>& events) {
@@ -81,28 +99,29 @@ public:
   }
 
   bool verify(VerificationSetting& ver) {
+    if(DeviceInit::isEnabled()) {
+      const auto indices = DeviceInit::getSampleIndices(args.problem_size);
+      const auto samples = membership_buf.gather_samples(args.device_queue, indices);
+      for(size_t s = 0; s < indices.size(); ++s) {
+        if(samples[s] != getExpectedMembership(indices[s])) {
+          std::cout << "Fail at = " << indices[s] << "Expected = " << getExpectedMembership(indices[s])
+                    << "Actual =" << samples[s] << std::endl;
+          return false;
+        }
+      }
+      return true;
+    }
+
     auto membership_acc = membership_buf.get_host_access();
 
     bool pass = true;
     unsigned int equal = 1;
 
     for(size_t x = 0; x < args.problem_size; ++x) {
-      int index = 0;
-      T min_dist = 500000.0f;
-      for(size_t i = 0; i < nclusters; i++) {
-        T dist = 0;
-        for(size_t l = 0; l < nfeatures; l++) {
-          dist += (features[l * args.problem_size + x] - clusters[i * nfeatures + l]) *
-                  (features[l * args.problem_size + x] - clusters[i * nfeatures + l]);
-        }
-        if(dist < min_dist) {
-          min_dist = dist;
-          index = x;
-        }
-      }
+      const int index = getExpectedMembership(x);
       if(membership_acc[x] != index) {
         equal = 0;
-        std::cout << "Fail at = " << x << "Expected = " << index << "Actual =" << membership[x] << std::endl;
+        std::cout << "Fail at = " << x << "Expected = " << index << "Actual =" << membership_acc[x] << std::endl;
         break;
       }
     }
@@ -113,6 +132,27 @@ public:
     return pass;
   }
 
+  // Recomputes the membership of point x from the generators of the inputs
+  int getExpectedMembership(size_t x) const {
+    int index = 0;
+    T min_dist = 500000.0f;
+    for(size_t i = 0; i < nclusters; i++) {
+      T dist = 0;
+      for(size_t l = 0; l < nfeatures; l++) {
+        const T feature = KmeansFeatures<T>{}(l * args.problem_size + x);
+        const T cluster = KmeansClusters<T>{}(i * nfeatures + l);
+        dist += (feature - cluster) * (feature - cluster);
+      }
+      if(dist < min_dist) {
+        min_dist = dist;
+        index = x;
+      }
+    }
+    return index;
+  }
+
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) {
     std::stringstream name;
     name << "Kmeans_";
@@ -121,11 +161,9 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+SYCL_BENCH_SUITE(kmeans, "single-kernel", app) {
   app.run<KmeansBench<float>>();
   if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
     app.run<KmeansBench<double>>();
   }
-  return 0;
 }
@@ -30,6 +30,9 @@ protected:
 public:
   LinearRegressionCoeffBench(const BenchmarkArgs& _args) : args(_args) {}
 
+  // Local memory required per work group, used to bound the candidates of --autotune-local
+  static std::size_t getLocalMemoryUsage(const BenchmarkArgs& args) { return args.local_size * sizeof(T); }
+
   void setup() {
     // host memory allocation and initialization
     input1.resize(args.problem_size);
@@ -39,10 +42,10 @@ public:
     input1ver.resize(args.problem_size);
     input2ver.resize(args.problem_size);
 
-    for(size_t i = 0; i < args.problem_size; i++) {
-      input1ver[i] = input1[i] = 1.0;
-      input2ver[i] = input2[i] = 2.0;
-    }
+    generateInput(input1.data(), args.problem_size, [](size_t) { return T{1}; });
+    generateInput(input2.data(), args.problem_size, [](size_t) { return T{2}; });
+    generateInput(input1ver.data(), args.problem_size, [](size_t) { return T{1}; });
+    generateInput(input2ver.data(), args.problem_size, [](size_t) { return T{2}; });
 
     input1_buf.initialize(args.device_queue, input1.data(), s::range<1>(args.problem_size));
     input2_buf.initialize(args.device_queue, input2.data(), s::range<1>(args.problem_size));
@@ -187,13 +190,11 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+SYCL_BENCH_SUITE(lin_reg_coeff, "single-kernel", app) {
   if(app.shouldRunNDRangeKernels()) {
     app.run<LinearRegressionCoeffBench<float>>();
     if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
       app.run<LinearRegressionCoeffBench<double>>();
     }
   }
-  return 0;
 }
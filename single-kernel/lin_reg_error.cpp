@@ -35,12 +35,10 @@ public:
     output.resize(args.problem_size, 0);
     expected_output.resize(args.problem_size, 0);
 
-    for(size_t i = 0; i < args.problem_size; i++) {
-      input1[i] = static_cast<T>(rand()) / static_cast<T>(RAND_MAX);
-      input2[i] = static_cast<T>(rand()) / static_cast<T>(RAND_MAX);
-      alpha[i] = static_cast<T>(rand()) / static_cast<T>(RAND_MAX);
-      beta[i] = static_cast<T>(rand()) / static_cast<T>(RAND_MAX);
-    }
+    generateUniform(input1.data(), args.problem_size, T{0}, T{1}, 1);
+    generateUniform(input2.data(), args.problem_size, T{0}, T{1}, 2);
+    generateUniform(alpha.data(), args.problem_size, T{0}, T{1}, 3);
+    generateUniform(beta.data(), args.problem_size, T{0}, T{1}, 4);
 
     input1_buf.initialize(args.device_queue, input1.data(), s::range<1>(args.problem_size));
     input2_buf.initialize(args.device_queue, input2.data(), s::range<1>(args.problem_size));
@@ -116,6 +114,8 @@ public:
     return compare(expected_output, args.problem_size, 0.000001);
   }
 
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) {
     std::stringstream name;
     name << "LinearRegression_";
@@ -124,11 +124,9 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+SYCL_BENCH_SUITE(lin_reg_error, "single-kernel", app) {
   app.run<LinearRegressionBench<float>>();
   if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
     app.run<LinearRegressionBench<double>>();
   }
-  return 0;
 }
@@ -40,7 +40,7 @@ public:
   void setup() {
     size = args.problem_size; // input size defined by the user
     input.resize(size * size);
-    load_bitmap_mirrored("../share/Brommy.bmp", size, input);
+    load_bitmap_mirrored(size, input);
     output.resize(size * size);
 
     input_buf.initialize(args.device_queue, input.data(), s::range<2>(size, size));
@@ -176,13 +176,13 @@ public:
   }
 
 
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) { return "MedianFilter"; }
 
 }; // MedianFilterBench class
 
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+SYCL_BENCH_SUITE(median, "single-kernel", app) {
   app.run<MedianFilterBench>();
-  return 0;
 }
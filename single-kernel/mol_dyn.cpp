@@ -135,11 +135,11 @@ public:
     return pass;
   }
 
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) { return "MolecularDynamics"; }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+SYCL_BENCH_SUITE(mol_dyn, "single-kernel", app) {
   app.run<MolecularDynamicsBench>();
-  return 0;
 }
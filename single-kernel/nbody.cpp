@@ -6,13 +6,13 @@
 
 using namespace sycl;
 
-template <class float_type>
+template <class float_type, MemoryBackend Backend>
 class NDRangeNBodyKernel;
-template <class float_type>
+template <class float_type, MemoryBackend Backend>
 class HierarchicalNBodyKernel;
 
 
-template <class float_type>
+template <class float_type, MemoryBackend Backend>
 class NBody {
 protected:
   using particle_type = sycl::vec<float_type, 4>;
@@ -27,17 +27,22 @@ protected:
   const float_type gravitational_softening;
   const float_type dt;
 
-  PrefetchedBuffer<particle_type> output_particles;
-  PrefetchedBuffer<vector_type> output_velocities;
+  DeviceData<particle_type, 1, Backend> output_particles;
+  DeviceData<vector_type, 1, Backend> output_velocities;
 
-  PrefetchedBuffer<particle_type> particles_buf;
-  PrefetchedBuffer<vector_type> velocities_buf;
+  DeviceData<particle_type, 1, Backend> particles_buf;
+  DeviceData<vector_type, 1, Backend> velocities_buf;
 
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   NBody(const BenchmarkArgs& _args) : args(_args), gravitational_softening{1.e-5f}, dt{1.e-2f} {
     assert(args.problem_size % args.local_size == 0);
   }
 
+  // Local memory required per work group, used to bound the candidates of --autotune-local
+  static std::size_t getLocalMemoryUsage(const BenchmarkArgs& args) { return args.local_size * sizeof(particle_type); }
+
   void setup() {
     particles.resize(args.problem_size);
     velocities.resize(args.problem_size);
@@ -113,19 +118,19 @@ protected:
     });
   }
 
-  void submitNDRange(std::vector<sycl::event>& events, sycl::buffer<particle_type>& particles, sycl::buffer<vector_type>& velocities) {
+  void submitNDRange(std::vector<sycl::event>& events) {
    events.push_back(args.device_queue.submit([&](sycl::handler& cgh) {
       sycl::nd_range<1> execution_range{sycl::range<1>{args.problem_size}, sycl::range<1>{args.local_size}};
 
-      auto particles_access = particles.template get_access<sycl::access::mode::read>(cgh);
-      auto velocities_access = velocities.template get_access<sycl::access::mode::read>(cgh);
+      auto particles_access = particles_buf.template get_access<sycl::access::mode::read>(cgh);
+      auto velocities_access = velocities_buf.template get_access<sycl::access::mode::read>(cgh);
 
       auto output_particles_access = output_particles.template get_access<sycl::access::mode::discard_write>(cgh);
       auto output_velocities_access = output_velocities.template get_access<sycl::access::mode::discard_write>(cgh);
 
       auto scratch = sycl::local_accessor<particle_type, 1>{sycl::range<1>{args.local_size}, cgh};
 
-      cgh.parallel_for<NDRangeNBodyKernel<float_type>>(execution_range,
+      cgh.parallel_for<NDRangeNBodyKernel<float_type, Backend>>(execution_range,
           [=, dt = this->dt, gravitational_softening = this->gravitational_softening](sycl::nd_item<1> tid) {
             const size_t global_id = tid.get_global_id(0);
             const size_t local_id = tid.get_local_id(0);
@@ -179,12 +184,12 @@ protected:
     }));
   }
 
-  void submitHierarchical(std::vector<sycl::event>& events, sycl::buffer<particle_type>& particles, sycl::buffer<vector_type>& velocities) {
+  void submitHierarchical(std::vector<sycl::event>& events) {
     events.push_back(args.device_queue.submit([&](sycl::handler& cgh) {
       sycl::nd_range<1> execution_range{sycl::range<1>{args.problem_size}, sycl::range<1>{args.local_size}};
 
-      auto particles_access = particles.template get_access<sycl::access::mode::read>(cgh);
-      auto velocities_access = velocities.template get_access<sycl::access::mode::read>(cgh);
+      auto particles_access = particles_buf.template get_access<sycl::access::mode::read>(cgh);
+      auto velocities_access = velocities_buf.template get_access<sycl::access::mode::read>(cgh);
 
       auto output_particles_access = output_particles.template get_access<sycl::access::mode::discard_write>(cgh);
       auto output_velocities_access = output_velocities.template get_access<sycl::access::mode::discard_write>(cgh);
@@ -194,8 +199,8 @@ protected:
 
       const size_t local_size = args.local_size;
       const size_t problem_size = args.problem_size;
-      cgh.parallel_for_work_group<HierarchicalNBodyKernel<float_type>>(sycl::range<1>{problem_size / local_size},
-          sycl::range<1>{local_size},
+      cgh.parallel_for_work_group<HierarchicalNBodyKernel<float_type, Backend>>(
+          sycl::range<1>{problem_size / local_size}, sycl::range<1>{local_size},
           [=, dt = this->dt, gravitational_softening = this->gravitational_softening](sycl::group<1> grp) {
             sycl::private_memory<particle_type> my_particle{grp};
             sycl::private_memory<vector_type> acceleration{grp};
@@ -256,16 +261,18 @@ protected:
   }
 };
 
-template <class float_type>
-class NBodyNDRange : public NBody<float_type> {
+template <class float_type, MemoryBackend Backend = MemoryBackend::buffer>
+class NBodyNDRange : public NBody<float_type, Backend> {
 public:
-  using typename NBody<float_type>::particle_type;
-  using typename NBody<float_type>::vector_type;
+  using typename NBody<float_type, Backend>::particle_type;
+  using typename NBody<float_type, Backend>::vector_type;
+
+  NBodyNDRange(const BenchmarkArgs& _args) : NBody<float_type, Backend>{_args} {}
 
-  NBodyNDRange(const BenchmarkArgs& _args) : NBody<float_type>{_args} {}
 
+  void run(std::vector<sycl::event>& events) { this->submitNDRange(events); }
 
-  void run(std::vector<sycl::event>& events) { this->submitNDRange(events, this->particles_buf.get(), this->velocities_buf.get()); }
+  static constexpr bool idempotent = true;
 
   std::string getBenchmarkName(BenchmarkArgs& args) {
     std::stringstream name;
@@ -276,16 +283,18 @@ public:
 };
 
 
-template <class float_type>
-class NBodyHierarchical : public NBody<float_type> {
+template <class float_type, MemoryBackend Backend = MemoryBackend::buffer>
+class NBodyHierarchical : public NBody<float_type, Backend> {
 public:
-  using typename NBody<float_type>::particle_type;
-  using typename NBody<float_type>::vector_type;
+  using typename NBody<float_type, Backend>::particle_type;
+  using typename NBody<float_type, Backend>::vector_type;
 
-  NBodyHierarchical(const BenchmarkArgs& _args) : NBody<float_type>{_args} {}
+  NBodyHierarchical(const BenchmarkArgs& _args) : NBody<float_type, Backend>{_args} {}
 
 
-  void run(std::vector<sycl::event>& events) { this->submitHierarchical(events, this->particles_buf.get(), this->velocities_buf.get()); }
+  void run(std::vector<sycl::event>& events) { this->submitHierarchical(events); }
+
+  static constexpr bool idempotent = true;
 
   std::string getBenchmarkName(BenchmarkArgs& args) {
     std::stringstream name;
@@ -296,19 +305,17 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-
-  app.run<NBodyHierarchical<float>>();
-  if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
-    app.run<NBodyHierarchical<double>>();
-  }
-  if(app.shouldRunNDRangeKernels()) {
-    app.run<NBodyNDRange<float>>();
+SYCL_BENCH_SUITE(nbody, "single-kernel", app) {
+  app.forEachMemoryBackend([&](auto backend) {
+    app.run<NBodyHierarchical<float, backend>>();
     if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
-      app.run<NBodyNDRange<double>>();
+      app.run<NBodyHierarchical<double, backend>>();
     }
-  }
-
-  return 0;
+    if(app.shouldRunNDRangeKernels()) {
+      app.run<NBodyNDRange<float, backend>>();
+      if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
+        app.run<NBodyNDRange<double, backend>>();
+      }
+    }
+  });
 }
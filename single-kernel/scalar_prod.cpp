@@ -7,19 +7,19 @@
 // using namespace sycl;
 namespace s = sycl;
 
-template <typename T, bool>
+template <typename T, bool, MemoryBackend>
 class ScalarProdKernel;
-template <typename T, bool>
+template <typename T, bool, MemoryBackend>
 class ScalarProdKernelHierarchical;
 
-template <typename T, bool>
+template <typename T, bool, MemoryBackend>
 class ScalarProdReduction;
-template <typename T, bool>
+template <typename T, bool, MemoryBackend>
 class ScalarProdReductionHierarchical;
-template <typename T, bool>
+template <typename T, bool, MemoryBackend>
 class ScalarProdGatherKernel;
 
-template <typename T, bool Use_ndrange = true>
+template <typename T, bool Use_ndrange = true, MemoryBackend Backend = MemoryBackend::buffer>
 class ScalarProdBench {
 protected:
   std::vector<T> input1;
@@ -27,13 +27,18 @@ protected:
   std::vector<T> output;
   BenchmarkArgs args;
 
-  PrefetchedBuffer<T, 1> input1_buf;
-  PrefetchedBuffer<T, 1> input2_buf;
-  PrefetchedBuffer<T, 1> output_buf;
+  DeviceData<T, 1, Backend> input1_buf;
+  DeviceData<T, 1, Backend> input2_buf;
+  DeviceData<T, 1, Backend> output_buf;
 
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   ScalarProdBench(const BenchmarkArgs& _args) : args(_args) {}
 
+  // Local memory required per work group, used to bound the candidates of --autotune-local
+  static std::size_t getLocalMemoryUsage(const BenchmarkArgs& args) { return args.local_size * sizeof(T); }
+
   void setup() {
     // host memory allocation and initialization
     input1.resize(args.problem_size);
@@ -61,12 +66,12 @@ public:
       if(Use_ndrange) {
         sycl::nd_range<1> ndrange(args.problem_size, args.local_size);
 
-        cgh.parallel_for<class ScalarProdKernel<T, Use_ndrange>>(ndrange, [=](sycl::nd_item<1> item) {
+        cgh.parallel_for<class ScalarProdKernel<T, Use_ndrange, Backend>>(ndrange, [=](sycl::nd_item<1> item) {
           size_t gid = item.get_global_linear_id();
           intermediate_product[gid] = in1[gid] * in2[gid];
         });
       } else {
-        cgh.parallel_for_work_group<class ScalarProdKernelHierarchical<T, Use_ndrange>>(
+        cgh.parallel_for_work_group<class ScalarProdKernelHierarchical<T, Use_ndrange, Backend>>(
             sycl::range<1>{args.problem_size / args.local_size}, sycl::range<1>{args.local_size},
             [=](sycl::group<1> grp) {
               grp.parallel_for_work_item([&](sycl::h_item<1> idx) {
@@ -97,7 +102,7 @@ public:
         sycl::nd_range<1> ndrange(n_wgroups * wgroup_size, wgroup_size);
 
         if(Use_ndrange) {
-          cgh.parallel_for<class ScalarProdReduction<T, Use_ndrange>>(ndrange, [=](sycl::nd_item<1> item) {
+          cgh.parallel_for<class ScalarProdReduction<T, Use_ndrange, Backend>>(ndrange, [=](sycl::nd_item<1> item) {
             size_t gid = item.get_global_linear_id();
             size_t lid = item.get_local_linear_id();
 
@@ -128,7 +133,7 @@ public:
             }
           });
         } else {
-          cgh.parallel_for_work_group<class ScalarProdReductionHierarchical<T, Use_ndrange>>(
+          cgh.parallel_for_work_group<class ScalarProdReductionHierarchical<T, Use_ndrange, Backend>>(
               sycl::range<1>{n_wgroups}, sycl::range<1>{wgroup_size}, [=](sycl::group<1> grp) {
                 grp.parallel_for_work_item([&](sycl::h_item<1> idx) {
                   const size_t gid = idx.get_global_id(0);
@@ -168,7 +173,7 @@ public:
       events.push_back(args.device_queue.submit([&](sycl::handler& cgh) {
         auto global_mem = output_buf.template get_access<s::access::mode::read_write>(cgh);
 
-        cgh.parallel_for<ScalarProdGatherKernel<T, Use_ndrange>>(
+        cgh.parallel_for<ScalarProdGatherKernel<T, Use_ndrange, Backend>>(
             sycl::range<1>{n_wgroups}, [=](sycl::id<1> idx) { global_mem[idx] = global_mem[idx * wgroup_size]; });
       }));
       array_size = n_wgroups;
@@ -197,6 +202,8 @@ public:
     return pass;
   }
 
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) {
     std::stringstream name;
     name << "ScalarProduct_";
@@ -206,22 +213,161 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  if(app.shouldRunNDRangeKernels()) {
-    app.run<ScalarProdBench<int, true>>();
-    app.run<ScalarProdBench<long long, true>>();
-    app.run<ScalarProdBench<float, true>>();
-    if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
-      app.run<ScalarProdBench<double, true>>();
+template <typename T>
+class ScalarProdStreamingKernel;
+
+/**
+ * Out-of-core variant of ScalarProdBench (--streaming): the vectors stay in pinned host memory. Every tile
+ * is reduced to one partial sum per work group on the device (see StreamingPipeline), and the partial sums
+ * of all tiles are added up on the host.
+ */
+template <typename T>
+class ScalarProdStreamingBench {
+protected:
+  BenchmarkArgs args;
+  USMBuffer<T, 1, s::usm::alloc::host> input1;
+  USMBuffer<T, 1, s::usm::alloc::host> input2;
+  // max_groups partial sums per tile
+  USMBuffer<T, 1, s::usm::alloc::host> partial_sums;
+  StreamingPipeline pipeline;
+  // Every slot holds the tiles of input1 and input2 followed by max_groups partial sums
+  T* device_tiles = nullptr;
+  T result = 0;
+
+  // Work groups iterate over the tile, so that there are only few partial sums to copy back
+  static constexpr std::size_t max_groups = 1024;
+
+  std::size_t getSlotSize() const { return 2 * pipeline.getTileElements() + max_groups; }
+
+  T* getTile(const StreamingTile& tile, std::size_t array) const {
+    return device_tiles + tile.slot * getSlotSize() + array * pipeline.getTileElements();
+  }
+
+  std::size_t getNumGroups(const StreamingTile& tile) const {
+    return std::min(max_groups, (tile.count + args.local_size - 1) / args.local_size);
+  }
+
+public:
+  ScalarProdStreamingBench(const BenchmarkArgs& _args) : args(_args), pipeline{_args.problem_size, 2 * sizeof(T)} {}
+
+  ~ScalarProdStreamingBench() {
+    if(device_tiles != nullptr)
+      s::free(device_tiles, args.device_queue);
+  }
+
+  static std::size_t getLocalMemoryUsage(const BenchmarkArgs& args) { return args.local_size * sizeof(T); }
+
+  void setup() {
+    const std::size_t n = args.problem_size;
+    input1.initialize(args.device_queue, n);
+    input2.initialize(args.device_queue, n);
+    partial_sums.initialize(args.device_queue, pipeline.getNumTiles() * max_groups);
+    generateInput(input1.get(), n, [](std::size_t) { return static_cast<T>(1); });
+    generateInput(input2.get(), n, [](std::size_t) { return static_cast<T>(2); });
+    device_tiles = s::malloc_device<T>(getSlotSize() * pipeline.getDepth(), args.device_queue);
+
+    pipeline.setStages(
+        [this](const StreamingTile& tile, const s::event& dependency) {
+          const auto bytes = tile.count * sizeof(T);
+          const auto first =
+              args.device_queue.memcpy(getTile(tile, 0), input1.get() + tile.offset, bytes, dependency);
+          return args.device_queue.memcpy(getTile(tile, 1), input2.get() + tile.offset, bytes, first);
+        },
+        [this](const StreamingTile& tile, const s::event& dependency) {
+          return args.device_queue.submit([&](s::handler& cgh) {
+            cgh.depends_on(dependency);
+            const T* in1 = getTile(tile, 0);
+            const T* in2 = getTile(tile, 1);
+            T* partial = getTile(tile, 2);
+            const std::size_t count = tile.count;
+            const std::size_t local_size = args.local_size;
+            auto local_mem = s::local_accessor<T, 1>{s::range<1>(local_size), cgh};
+            const s::nd_range<1> ndrange{getNumGroups(tile) * local_size, local_size};
+
+            cgh.parallel_for<ScalarProdStreamingKernel<T>>(ndrange, [=](s::nd_item<1> item) {
+              const std::size_t lid = item.get_local_linear_id();
+              T sum = 0;
+              for(std::size_t i = item.get_global_linear_id(); i < count; i += item.get_global_range(0)) {
+                sum += in1[i] * in2[i];
+              }
+              local_mem[lid] = sum;
+              s::group_barrier(item.get_group());
+
+              for(std::size_t stride = local_size / 2; stride >= 1; stride /= 2) {
+                if(lid < stride)
+                  local_mem[lid] += local_mem[lid + stride];
+                s::group_barrier(item.get_group());
+              }
+              if(lid == 0)
+                partial[item.get_group_linear_id()] = local_mem[0];
+            });
+          });
+        },
+        [this](const StreamingTile& tile, const s::event& dependency) {
+          return args.device_queue.memcpy(partial_sums.get() + tile.index * max_groups, getTile(tile, 2),
+              getNumGroups(tile) * sizeof(T), dependency);
+        });
+    pipeline.calibrate();
+  }
+
+  void run() {
+    pipeline.run();
+    result = 0;
+    for(std::size_t t = 0; t < pipeline.getNumTiles(); ++t) {
+      const std::size_t offset = t * pipeline.getTileElements();
+      const std::size_t count = std::min(pipeline.getTileElements(), args.problem_size - offset);
+      const std::size_t num_groups = getNumGroups(StreamingTile{t, 0, offset, count});
+      for(std::size_t g = 0; g < num_groups; ++g) result += partial_sums.get()[t * max_groups + g];
     }
   }
 
-  app.run<ScalarProdBench<int, false>>();
-  app.run<ScalarProdBench<long long, false>>();
-  app.run<ScalarProdBench<float, false>>();
-  if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
-    app.run<ScalarProdBench<double, false>>();
+  bool verify(VerificationSetting& ver) {
+    const auto expected = static_cast<double>(args.problem_size) * 2.0;
+    // Relative tolerance, as the sums become large for out-of-core problem sizes
+    return std::fabs(expected - static_cast<double>(result)) <= 0.00001 * expected;
+  }
+
+  // End-to-end throughput in bytes copied to the device
+  static ThroughputMetric getThroughputMetric(const BenchmarkArgs& args) {
+    return {2.0 * args.problem_size * sizeof(T) / 1024.0 / 1024.0 / 1024.0, "GiB"};
+  }
+
+  static constexpr bool idempotent = true;
+
+  static std::string getBenchmarkName(BenchmarkArgs& args) {
+    std::stringstream name;
+    name << "ScalarProduct_Streaming_";
+    name << ReadableTypename<T>::name;
+    return name.str();
   }
-  return 0;
+};
+
+SYCL_BENCH_SUITE(scalar_prod, "single-kernel", app) {
+  if(app.shouldRunStreaming()) {
+    app.run<ScalarProdStreamingBench<int>>();
+    app.run<ScalarProdStreamingBench<long long>>();
+    app.run<ScalarProdStreamingBench<float>>();
+    if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
+      app.run<ScalarProdStreamingBench<double>>();
+    }
+    return;
+  }
+
+  app.forEachMemoryBackend([&](auto backend) {
+    if(app.shouldRunNDRangeKernels()) {
+      app.run<ScalarProdBench<int, true, backend>>();
+      app.run<ScalarProdBench<long long, true, backend>>();
+      app.run<ScalarProdBench<float, true, backend>>();
+      if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
+        app.run<ScalarProdBench<double, true, backend>>();
+      }
+    }
+
+    app.run<ScalarProdBench<int, false, backend>>();
+    app.run<ScalarProdBench<long long, false, backend>>();
+    app.run<ScalarProdBench<float, false, backend>>();
+    if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
+      app.run<ScalarProdBench<double, false, backend>>();
+    }
+  });
 }
@@ -7,10 +7,10 @@
 // avoid it
 // using namespace sycl;
 namespace s = sycl;
-template <typename T>
+template <typename T, MemoryBackend Backend>
 class VecAddKernel;
 
-template <typename T>
+template <typename T, MemoryBackend Backend = MemoryBackend::buffer>
 class VecAddBench {
 protected:
   std::vector<T> input1;
@@ -18,11 +18,13 @@ protected:
   std::vector<T> output;
   BenchmarkArgs args;
 
-  PrefetchedBuffer<T, 1> input1_buf;
-  PrefetchedBuffer<T, 1> input2_buf;
-  PrefetchedBuffer<T, 1> output_buf;
+  DeviceData<T, 1, Backend> input1_buf;
+  DeviceData<T, 1, Backend> input2_buf;
+  DeviceData<T, 1, Backend> output_buf;
 
 public:
+  static constexpr MemoryBackend memory_backend = Backend;
+
   VecAddBench(const BenchmarkArgs& _args) : args(_args) {}
 
   void setup() {
@@ -50,7 +52,8 @@ public:
       auto out = output_buf.template get_access<s::access::mode::discard_write>(cgh);
       sycl::range<1> ndrange{args.problem_size};
 
-      cgh.parallel_for<class VecAddKernel<T>>(ndrange, [=](sycl::id<1> gid) { out[gid] = in1[gid] + in2[gid]; });
+      cgh.parallel_for<class VecAddKernel<T, Backend>>(
+          ndrange, [=](sycl::id<1> gid) { out[gid] = in1[gid] + in2[gid]; });
     }));
   }
 
@@ -69,6 +72,12 @@ public:
     return pass;
   }
 
+  static double getBytesMoved(const BenchmarkArgs& args) { return 3.0 * args.problem_size * sizeof(T); }
+
+  static double getFlops(const BenchmarkArgs& args) { return static_cast<double>(args.problem_size); }
+
+  static constexpr bool idempotent = true;
+
   static std::string getBenchmarkName(BenchmarkArgs& args) {
     std::stringstream name;
     name << "VectorAddition_";
@@ -77,13 +86,110 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
-  app.run<VecAddBench<int>>();
-  app.run<VecAddBench<long long>>();
-  app.run<VecAddBench<float>>();
-  if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
-    app.run<VecAddBench<double>>();
+template <typename T>
+class VecAddStreamingKernel;
+
+/**
+ * Out-of-core variant of VecAddBench (--streaming): the vectors stay in pinned host memory and are added
+ * tile by tile through a StreamingPipeline, so the problem size is only limited by host memory.
+ */
+template <typename T>
+class VecAddStreamingBench {
+protected:
+  BenchmarkArgs args;
+  USMBuffer<T, 1, s::usm::alloc::host> input1;
+  USMBuffer<T, 1, s::usm::alloc::host> input2;
+  USMBuffer<T, 1, s::usm::alloc::host> output;
+  StreamingPipeline pipeline;
+  // Every slot holds the tiles of input1, input2 and output
+  T* device_tiles = nullptr;
+
+  T* getTile(const StreamingTile& tile, std::size_t array) const {
+    return device_tiles + (3 * tile.slot + array) * pipeline.getTileElements();
+  }
+
+public:
+  VecAddStreamingBench(const BenchmarkArgs& _args) : args(_args), pipeline{_args.problem_size, 3 * sizeof(T)} {}
+
+  ~VecAddStreamingBench() {
+    if(device_tiles != nullptr)
+      s::free(device_tiles, args.device_queue);
   }
-  return 0;
+
+  void setup() {
+    const std::size_t n = args.problem_size;
+    input1.initialize(args.device_queue, n);
+    input2.initialize(args.device_queue, n);
+    output.initialize(args.device_queue, n);
+    generateInput(input1.get(), n, [](std::size_t i) { return static_cast<T>(i); });
+    generateInput(input2.get(), n, [](std::size_t i) { return static_cast<T>(i); });
+    device_tiles = s::malloc_device<T>(3 * pipeline.getTileElements() * pipeline.getDepth(), args.device_queue);
+
+    pipeline.setStages(
+        [this](const StreamingTile& tile, const s::event& dependency) {
+          const auto bytes = tile.count * sizeof(T);
+          const auto first = args.device_queue.memcpy(getTile(tile, 0), input1.get() + tile.offset, bytes, dependency);
+          return args.device_queue.memcpy(getTile(tile, 1), input2.get() + tile.offset, bytes, first);
+        },
+        [this](const StreamingTile& tile, const s::event& dependency) {
+          return args.device_queue.submit([&](s::handler& cgh) {
+            cgh.depends_on(dependency);
+            const T* in1 = getTile(tile, 0);
+            const T* in2 = getTile(tile, 1);
+            T* out = getTile(tile, 2);
+            cgh.parallel_for<VecAddStreamingKernel<T>>(
+                s::range<1>{tile.count}, [=](s::id<1> gid) { out[gid] = in1[gid] + in2[gid]; });
+          });
+        },
+        [this](const StreamingTile& tile, const s::event& dependency) {
+          return args.device_queue.memcpy(
+              output.get() + tile.offset, getTile(tile, 2), tile.count * sizeof(T), dependency);
+        });
+    pipeline.calibrate();
+  }
+
+  void run() { pipeline.run(); }
+
+  bool verify(VerificationSetting& ver) {
+    for(size_t i = ver.begin[0]; i < ver.begin[0] + ver.range[0]; i++) {
+      if(input1.get()[i] + input2.get()[i] != output.get()[i])
+        return false;
+    }
+    return true;
+  }
+
+  // End-to-end throughput in bytes copied between host and device
+  static ThroughputMetric getThroughputMetric(const BenchmarkArgs& args) {
+    return {3.0 * args.problem_size * sizeof(T) / 1024.0 / 1024.0 / 1024.0, "GiB"};
+  }
+
+  static constexpr bool idempotent = true;
+
+  static std::string getBenchmarkName(BenchmarkArgs& args) {
+    std::stringstream name;
+    name << "VectorAddition_Streaming_";
+    name << ReadableTypename<T>::name;
+    return name.str();
+  }
+};
+
+SYCL_BENCH_SUITE(vec_add, "single-kernel", app) {
+  if(app.shouldRunStreaming()) {
+    app.run<VecAddStreamingBench<int>>();
+    app.run<VecAddStreamingBench<long long>>();
+    app.run<VecAddStreamingBench<float>>();
+    if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
+      app.run<VecAddStreamingBench<double>>();
+    }
+    return;
+  }
+
+  app.forEachMemoryBackend([&](auto backend) {
+    app.run<VecAddBench<int, backend>>();
+    app.run<VecAddBench<long long, backend>>();
+    app.run<VecAddBench<float, backend>>();
+    if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
+      app.run<VecAddBench<double, backend>>();
+    }
+  });
 }
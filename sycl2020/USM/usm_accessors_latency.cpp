@@ -162,8 +162,7 @@ void launchBenchmarks(BenchmarkApp& app, const size_t kernel_launches_num) {
   app.run<latency_kernel<float, true>>(kernel_launches_num); // in-order, no synch
 }
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+SYCL_BENCH_SUITE(usm_accessors_latency, "sycl2020/USM", app) {
   const size_t kernel_launches_num = app.getArgs().cli.getOrDefault("--num-launches", kernels_launch_default);
 
   launchBenchmarks<AccessorLatency>(app, kernel_launches_num);
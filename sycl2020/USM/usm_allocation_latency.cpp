@@ -22,6 +22,14 @@ public:
 
   void setup() {}
 
+  void reset() {
+    // run() allocates a new buffer each time
+    if(buffer != nullptr) {
+      sycl::free(buffer, args.device_queue);
+      buffer = nullptr;
+    }
+  }
+
   void run(std::vector<sycl::event>& events) {
     sycl::queue& queue = args.device_queue;
     buffer = static_cast<DATA_TYPE*>(sycl::malloc(args.problem_size * sizeof(DATA_TYPE), queue, usm_type));
@@ -60,12 +68,89 @@ public:
 };
 
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+/**
+Measure allocation throughput under churn, with and without the USMPool. Every run performs a fixed
+sequence of allocations of up to problem-size elements, each replacing a random live allocation of a
+small working set, as in applications allocating temporaries per step. The pool persists across runs,
+so after the first run the pooled variant mostly reuses cached blocks.
+*/
+template <typename DATA_TYPE, sycl::usm::alloc usm_type, bool pooled>
+class USMAllocationChurn {
+protected:
+  static constexpr std::size_t num_allocations = 256;
+  static constexpr std::size_t working_set = 16;
+
+  BenchmarkArgs args;
+  std::vector<std::pair<DATA_TYPE*, std::size_t>> live;
+  bool all_allocations_succeeded = true;
+
+public:
+  USMAllocationChurn(const BenchmarkArgs& _args) : args(_args), live(working_set, {nullptr, 0}) {}
+
+  void setup() {}
+
+  void run(std::vector<sycl::event>& events) {
+    const Philox4x32 rng{42};
+    for(std::size_t i = 0; i < num_allocations; ++i) {
+      const auto r = rng(i);
+      auto& [ptr, count] = live[r[0] % working_set];
+      release(ptr, count);
+      // Between a quarter of and the full problem size
+      count = std::max<std::size_t>(1, args.problem_size / 4 + r[1] % (3 * args.problem_size / 4 + 1));
+      ptr = allocate(count);
+      all_allocations_succeeded = all_allocations_succeeded && ptr != nullptr;
+    }
+    for(auto& [ptr, count] : live) {
+      release(ptr, count);
+      ptr = nullptr;
+    }
+  }
+
+  bool verify(VerificationSetting& settings) { return all_allocations_succeeded; }
+
+  static ThroughputMetric getThroughputMetric(const BenchmarkArgs& args) {
+    return {static_cast<double>(num_allocations), "allocations"};
+  }
+
+  static std::string getBenchmarkName(BenchmarkArgs& args) {
+    std::stringstream name;
+    name << "USM_Allocation_churn_";
+    name << ReadableTypename<DATA_TYPE>::name << "_";
+    name << usm_to_string(usm_type) << "_";
+    name << (pooled ? "pooled" : "raw");
+    return name.str();
+  }
+
+private:
+  DATA_TYPE* allocate(std::size_t count) {
+    if constexpr(pooled) {
+      return static_cast<DATA_TYPE*>(USMPool::get(args.device_queue, usm_type).allocate(count * sizeof(DATA_TYPE)));
+    } else {
+      return static_cast<DATA_TYPE*>(sycl::malloc(count * sizeof(DATA_TYPE), args.device_queue, usm_type));
+    }
+  }
+
+  void release(DATA_TYPE* ptr, std::size_t count) {
+    if(ptr == nullptr)
+      return;
+    if constexpr(pooled) {
+      USMPool::get(args.device_queue, usm_type).deallocate(ptr, count * sizeof(DATA_TYPE));
+    } else {
+      sycl::free(ptr, args.device_queue);
+    }
+  }
+};
+
 
+SYCL_BENCH_SUITE(usm_allocation_latency, "sycl2020/USM", app) {
   app.run<USMAllocationLatency<float, sycl::usm::alloc::device>>();
   app.run<USMAllocationLatency<float, sycl::usm::alloc::host>>();
   app.run<USMAllocationLatency<float, sycl::usm::alloc::shared>>();
 
-  return 0;
+  app.run<USMAllocationChurn<float, sycl::usm::alloc::device, false>>();
+  app.run<USMAllocationChurn<float, sycl::usm::alloc::device, true>>();
+  app.run<USMAllocationChurn<float, sycl::usm::alloc::host, false>>();
+  app.run<USMAllocationChurn<float, sycl::usm::alloc::host, true>>();
+  app.run<USMAllocationChurn<float, sycl::usm::alloc::shared, false>>();
+  app.run<USMAllocationChurn<float, sycl::usm::alloc::shared, true>>();
 }
\ No newline at end of file
@@ -107,8 +107,7 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+SYCL_BENCH_SUITE(usm_instr_mix, "sycl2020/USM", app) {
   const size_t kernel_launches_num = app.getArgs().cli.getOrDefault("--num-launches", d_kernel_launch);
   const float instr_mix = app.getArgs().cli.getOrDefault("--instr-mix", d_instr_mix);
 
@@ -27,12 +27,8 @@ private:
     }
   }
 
-public:
-  USMPinnedOverhead(const BenchmarkArgs& _args, size_t num_copies)
-      : args(_args), buffer(nullptr), host_memory(nullptr), num_copies(num_copies) {}
-
-  ~USMPinnedOverhead() {
-    if(buffer == nullptr || host_memory == nullptr) {
+  void free_host_memory() {
+    if(host_memory == nullptr) {
       return;
     }
     if constexpr(use_pinned_memory) {
@@ -40,7 +36,18 @@ public:
     } else {
       free(host_memory);
     }
-    sycl::free(buffer, args.device_queue);
+    host_memory = nullptr;
+  }
+
+public:
+  USMPinnedOverhead(const BenchmarkArgs& _args, size_t num_copies)
+      : args(_args), buffer(nullptr), host_memory(nullptr), num_copies(num_copies) {}
+
+  ~USMPinnedOverhead() {
+    free_host_memory();
+    if(buffer != nullptr) {
+      sycl::free(buffer, args.device_queue);
+    }
   }
 
   void setup() {
@@ -51,6 +58,13 @@ public:
     buffer = (DATA_TYPE*)sycl::malloc_device(args.problem_size * sizeof(DATA_TYPE), queue);
   }
 
+  void reset() {
+    // run() allocates the host memory each time when including initialization
+    if constexpr(include_init) {
+      free_host_memory();
+    }
+  }
+
   void run(std::vector<sycl::event>& events) {
     sycl::queue& queue = args.device_queue;
     if constexpr(include_init) {
@@ -87,15 +101,11 @@ public:
   }
 };
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+SYCL_BENCH_SUITE(usm_pinned_overhead, "sycl2020/USM", app) {
   const size_t num_copies = app.getArgs().cli.getOrDefault("--num-copies", d_num_copies);
 
   app.run<USMPinnedOverhead<float, false, HOST_DEVICE, true>>(num_copies);
   app.run<USMPinnedOverhead<float, true, HOST_DEVICE, true>>(num_copies);
   app.run<USMPinnedOverhead<float, false, DEVICE_HOST, true>>(num_copies);
   app.run<USMPinnedOverhead<float, true, DEVICE_HOST, true>>(num_copies);
-
-
-  return 0;
 }
\ No newline at end of file
@@ -65,12 +65,10 @@ public:
 };
 
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+SYCL_BENCH_SUITE(atomic_reduction, "sycl2020/atomics", app) {
   app.run<ReductionAtomic<int>>();
   app.run<ReductionAtomic<long long>>();
   app.run<ReductionAtomic<float>>();
 
   app.run<ReductionAtomic<double>>();
-  return 0;
 }
@@ -72,12 +72,10 @@ public:
 };
 
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+SYCL_BENCH_SUITE(reduce_over_group, "sycl2020/group_algorithms", app) {
   app.run<ReduceGroupAlgorithm<int>>();
   app.run<ReduceGroupAlgorithm<long long>>();
   app.run<ReduceGroupAlgorithm<float>>();
 
   app.run<ReduceGroupAlgorithm<double>>();
-  return 0;
 }
@@ -78,12 +78,10 @@ void runOperators(BenchmarkApp& app) {
   runCoarsening<T, sycl::plus<T>>(app);
 }
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+SYCL_BENCH_SUITE(kernel_reduction, "sycl2020/kernel_reduction", app) {
   runOperators<int>(app);
   runOperators<long long>(app);
   runOperators<float>(app);
 
   runOperators<double>(app);
-  return 0;
 }
@@ -69,8 +69,9 @@ public:
   void setup() {
     problem_size = (int)args.problem_size;
 
-    in_vec.resize(problem_size * problem_size);
-    std::fill(in_vec.begin(), in_vec.end(), getInitValue());
+    in_vec.resize(static_cast<std::size_t>(problem_size) * problem_size);
+    const T init_value = getInitValue();
+    generateInput(in_vec.data(), in_vec.size(), [=](std::size_t) { return init_value; });
 
     in_buf.initialize(args.device_queue, in_vec.data(), s::range<2>(problem_size, problem_size));
     out_buf.initialize(args.device_queue, in_vec.data(), s::range<2>(problem_size, problem_size));
@@ -201,13 +202,11 @@ void runAccessVariants(BenchmarkApp& app) {
   runLoopCounts<T, AccessVariants::constexpr_value>(app);
 }
 
-int main(int argc, char** argv) {
-  BenchmarkApp app(argc, argv);
+SYCL_BENCH_SUITE(spec_constant_convolution, "sycl2020/spec_constants", app) {
   runAccessVariants<int>(app);
   runAccessVariants<long long>(app);
   runAccessVariants<float>(app);
   if constexpr(SYCL_BENCH_HAS_FP64_SUPPORT) {
     runAccessVariants<double>(app);
   }
-  return 0;
 }